@@ -0,0 +1,202 @@
+//======== Copyright (c) 2021, FIT VUT Brno, All rights reserved. ============//
+//
+// Purpose:     Concurrent priority queue
+//
+// $NoKeywords: $ivs_project_1 $concurrent_priority_queue.cpp
+// $Author:     Martin Kubicka <xkubic45@stud.fit.vutbr.cz>
+// $Date:       $2022-03-09
+//============================================================================//
+/**
+ * @file concurrent_priority_queue.cpp
+ * @author Martin Kubicka
+ * 
+ * @brief Implementace metod prioritni fronty pro vice vlaken.
+ */
+
+#include <limits.h>
+
+#include <functional>
+#include <thread>
+
+#include "concurrent_priority_queue.h"
+
+//top of empty shard is smaller than any int
+const long long ConcurrentPriorityQueue::EMPTY_TOP = (long long)INT_MIN - 1;
+
+//creating shards
+ConcurrentPriorityQueue::ConcurrentPriorityQueue(size_t shardCount)
+{
+    if (shardCount == 0) {
+        shardCount = 2 * std::thread::hardware_concurrency();
+        if (shardCount == 0) {
+            shardCount = 2;
+        }
+    }
+
+    //shards end with padding, so hot members of two shards dont share cache line
+    for (size_t i = 0; i < shardCount; i++) {
+        Shard_t *shard = new Shard_t;
+        shard->top = EMPTY_TOP;
+        shard->length = 0;
+        m_shards.push_back(shard);
+    }
+}
+
+//deleting shards
+ConcurrentPriorityQueue::~ConcurrentPriorityQueue()
+{
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        delete m_shards[i];
+    }
+}
+
+//inserting value into random shard, which isnt locked by other thread
+void ConcurrentPriorityQueue::Insert(int value)
+{
+    Shard_t *shard = NULL;
+    for (size_t attempt = 0; attempt < m_shards.size(); attempt++) {
+        Shard_t *candidate = m_shards[RandomShard()];
+        if (candidate->lock.try_lock()) {
+            shard = candidate;
+            break;
+        }
+    }
+    //all tried shards were locked - waiting for random one instead of spinning
+    if (shard == NULL) {
+        shard = m_shards[RandomShard()];
+        shard->lock.lock();
+    }
+
+    shard->queue.Insert(value);
+    shard->length++;
+    UpdateTop(*shard);
+    shard->lock.unlock();
+}
+
+//removing value - it can be in any shard
+bool ConcurrentPriorityQueue::Remove(int value)
+{
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        Shard_t &shard = *m_shards[i];
+        //shard cant contain bigger value than its top
+        if (shard.top.load() < value) {
+            continue;
+        }
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (shard.queue.Remove(value)) {
+            shard.length--;
+            UpdateTop(shard);
+            return true;
+        }
+    }
+    return false;
+}
+
+//finding value in all shards
+bool ConcurrentPriorityQueue::Find(int value)
+{
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        Shard_t &shard = *m_shards[i];
+        if (shard.top.load() < value) {
+            continue;
+        }
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (shard.queue.Find(value) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//getting biggest top of all shards
+bool ConcurrentPriorityQueue::GetHead(int &value)
+{
+    long long best = EMPTY_TOP;
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        long long top = m_shards[i]->top.load();
+        if (top > best) {
+            best = top;
+        }
+    }
+    if (best == EMPTY_TOP) {
+        return false;
+    }
+    value = (int)best;
+    return true;
+}
+
+//removing bigger top of two random shards
+bool ConcurrentPriorityQueue::PopMax(int &value)
+{
+    //few tries with two random shards
+    for (size_t attempt = 0; attempt < m_shards.size(); attempt++) {
+        Shard_t *first = m_shards[RandomShard()];
+        Shard_t *second = m_shards[RandomShard()];
+        if (second->top.load() > first->top.load()) {
+            first = second;
+        }
+        if (first->top.load() == EMPTY_TOP) {
+            continue;
+        }
+        if (first->lock.try_lock()) {
+            bool popped = PopFrom(*first, value);
+            first->lock.unlock();
+            if (popped) {
+                return true;
+            }
+        }
+    }
+
+    //queue is (almost) empty - checking all shards
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        Shard_t &shard = *m_shards[i];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (PopFrom(shard, value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//getting lenght as sum of shard lenghts
+size_t ConcurrentPriorityQueue::Length()
+{
+    size_t length = 0;
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        length += m_shards[i]->length.load();
+    }
+    return length;
+}
+
+//xorshift generator, every thread has its own state
+size_t ConcurrentPriorityQueue::RandomShard()
+{
+    static thread_local size_t state = 0;
+    if (state == 0) {
+        state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    }
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state % m_shards.size();
+}
+
+//removing head of shard
+bool ConcurrentPriorityQueue::PopFrom(Shard_t &shard, int &value)
+{
+    if (!shard.queue.PopMax(value)) {
+        return false;
+    }
+    shard.length--;
+    UpdateTop(shard);
+    return true;
+}
+
+//publishing top of shard
+void ConcurrentPriorityQueue::UpdateTop(Shard_t &shard)
+{
+    PriorityQueue::Element_t *head = shard.queue.GetHead();
+    shard.top.store((head != NULL) ? head->value : EMPTY_TOP);
+}
+
+/*** Konec souboru concurrent_priority_queue.cpp ***/
@@ -0,0 +1,158 @@
+//======== Copyright (c) 2021, FIT VUT Brno, All rights reserved. ============//
+//
+// Purpose:     Concurrent priority queue
+//
+// $NoKeywords: $ivs_project_1 $concurrent_priority_queue.h
+// $Author:     Martin Kubicka <xkubic45@stud.fit.vutbr.cz>
+// $Date:       $2022-03-09
+//============================================================================//
+/**
+ * @file concurrent_priority_queue.h
+ * @author Martin Kubicka
+ * 
+ * @brief Definice rozhrani prioritni fronty pro vice vlaken.
+ */
+
+#pragma once
+
+#ifndef CONCURRENT_PRIORITY_QUEUE_H_
+#define CONCURRENT_PRIORITY_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "tdd_code.h"
+
+/**
+ * @brief The ConcurrentPriorityQueue class
+ * Prioritni fronta, kterou muze soucasne pouzivat vice vlaken (tzv. relaxed
+ * multi-queue). Polozky jsou rozdeleny do nekolika dilcich front
+ * (PriorityQueue), kazda ma vlastni zamek. Insert vlozi hodnotu do nahodne
+ * dilci fronty, PopMax vybere ze dvou nahodnych dilcich front tu s vetsi
+ * nejvetsi hodnotou. Vlakna se tak o zamek temer neprou, PopMax ale vraci
+ * pouze priblizne nejvetsi hodnotu.
+ * Rozhrani nevraci ukazatele na polozky (hodnoty se kopiruji pod zamkem),
+ * takze polozku nelze pouzit po jejim odstraneni jinym vlaknem.
+ */
+class ConcurrentPriorityQueue
+{
+public:
+    /**
+     * @brief ConcurrentPriorityQueue
+     * Konstruktor, vytvori prazdnou frontu.
+     * @param shardCount Pocet dilcich front, 0 znamena dvojnasobek poctu
+     * hardwarovych vlaken.
+     */
+    explicit ConcurrentPriorityQueue(size_t shardCount = 0);
+
+    /**
+     * @brief ~ConcurrentPriorityQueue
+     * Destruktor, odstrani vsechny polozky i frontu samotnou. Frontu v tu chvili
+     * nesmi pouzivat zadne jine vlakno.
+     */
+    ~ConcurrentPriorityQueue();
+
+    /**
+     * Fronta vlastni sve dilci fronty (a jejich zamky), kopirovat ji nelze.
+     */
+    ConcurrentPriorityQueue(const ConcurrentPriorityQueue &) = delete;
+    ConcurrentPriorityQueue &operator=(const ConcurrentPriorityQueue &) = delete;
+
+    /**
+     * @brief Insert
+     * Zaradi novou polozku s hodnotou "value" do fronty.
+     * @param value Hodnota nove polozky.
+     */
+    void Insert(int value);
+
+    /**
+     * @brief Remove
+     * Odstrani libovolnou polozku s hodnotou "value" z fronty.
+     * @param value Hodnota polozky, ktera ma byt odstranena.
+     * @return Vrati true, pokud byla polozka nalezena a odstranena, jinak vraci false.
+     */
+    bool Remove(int value);
+
+    /**
+     * @brief Find
+     * Zjisti, zda je ve fronte polozka s hodnotou "value".
+     * @param value Hodnota hledane polozky.
+     * @return Vrati true, pokud polozka s hodnotou "value" existuje, jinak vraci false.
+     */
+    bool Find(int value);
+
+    /**
+     * @brief GetHead
+     * Zjisti nejvetsi hodnotu ve fronte. Pokud fronta soucasne meni jina
+     * vlakna, jde o hodnotu z okamziku cteni jednotlivych dilcich front.
+     * @param value Sem se ulozi nejvetsi hodnota.
+     * @return Vrati false, pokud je fronta prazdna, jinak vraci true.
+     */
+    bool GetHead(int &value);
+
+    /**
+     * @brief PopMax
+     * Odstrani z fronty priblizne nejvetsi polozku a vrati jeji hodnotu.
+     * @param value Sem se ulozi hodnota odstranene polozky.
+     * @return Vrati false, pokud je fronta prazdna, jinak vraci true.
+     */
+    bool PopMax(int &value);
+
+    /**
+     * @brief Length
+     * Vraci delku fronty.
+     * @return Vrati delku fronty.
+     */
+    size_t Length();
+
+protected:
+    /**
+     * @brief The Shard_t struct
+     * Dilci fronta se zamkem. Nejvetsi hodnota a delka jsou navic ulozeny
+     * v atomickych promennych, aby je slo cist bez zamku.
+     * Na konci je vypln o velikosti cache line: at lezi dve dilci fronty
+     * v pameti jakkoliv blizko, jejich zamky a atomicke promenne jsou vzdy
+     * alespon CACHE_LINE_SIZE bytu od sebe, takze nesdili cache line.
+     */
+    struct Shard_t {
+        std::mutex lock;                ///< Zamek chranici "queue".
+        PriorityQueue queue;            ///< Polozky dilci fronty.
+
+        std::atomic<long long> top;     ///< Nejvetsi hodnota, nebo EMPTY_TOP.
+        std::atomic<size_t> length;     ///< Delka "queue" (meni se pod zamkem).
+
+        char padding[64];               ///< Vypln oddelujici nasledujici dilci frontu.
+    };
+
+    /**
+     * @brief RandomShard
+     * Vrati nahodnou dilci frontu (kazde vlakno ma vlastni generator).
+     * @return Index dilci fronty.
+     */
+    size_t RandomShard();
+
+    /**
+     * @brief PopFrom
+     * Odstrani nejvetsi polozku z dilci fronty "shard". Volajici drzi zamek.
+     * @param shard Dilci fronta.
+     * @param value Sem se ulozi hodnota odstranene polozky.
+     * @return Vrati false, pokud je dilci fronta prazdna, jinak vraci true.
+     */
+    static bool PopFrom(Shard_t &shard, int &value);
+
+    /**
+     * @brief UpdateTop
+     * Prepise atomickou nejvetsi hodnotu dilci fronty. Volajici drzi zamek.
+     * @param shard Dilci fronta.
+     */
+    static void UpdateTop(Shard_t &shard);
+
+    static const long long EMPTY_TOP;   ///< Hodnota "top" prazdne dilci fronty.
+
+    std::vector<Shard_t *> m_shards;    ///< Dilci fronty.
+};
+
+#endif // CONCURRENT_PRIORITY_QUEUE_H_
@@ -0,0 +1,171 @@
+//======== Copyright (c) 2021, FIT VUT Brno, All rights reserved. ============//
+//
+// Purpose:     Concurrent priority queue - tests suite
+//
+// $NoKeywords: $ivs_project_1 $concurrent_priority_queue_tests.cpp
+// $Author:     Martin Kubicka <xkubic45@stud.fit.vutbr.cz>
+// $Date:       $2022-03-09
+//============================================================================//
+/**
+ * @file concurrent_priority_queue_tests.cpp
+ * @author Martin Kubicka
+ * 
+ * @brief Implementace testu prioritni fronty pro vice vlaken.
+ */
+
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "concurrent_priority_queue.h"
+
+//============================================================================//
+// Testy verejneho rozhrani ConcurrentPriorityQueue v jednom vlakne a testy,
+// ze pri soucasnem pouziti z vice vlaken se zadna polozka neztrati ani
+// nezdvoji. Testy ma smysl poustet i v prekladu s -fsanitize=thread.
+//============================================================================//
+
+//queue owns its shards, copy would delete them twice
+static_assert(!std::is_copy_constructible<ConcurrentPriorityQueue>::value &&
+              !std::is_copy_assignable<ConcurrentPriorityQueue>::value,
+              "ConcurrentPriorityQueue must not be copyable");
+
+class EmptyConcurrentQueue : public ::testing::Test
+{
+protected:
+    ConcurrentPriorityQueue queue;
+
+    EmptyConcurrentQueue() : queue(4) {}
+};
+
+//testing empty queue
+TEST_F(EmptyConcurrentQueue, Empty) {
+    int value = 0;
+    EXPECT_EQ(queue.Length(), 0);
+    EXPECT_FALSE(queue.GetHead(value));
+    EXPECT_FALSE(queue.PopMax(value));
+    EXPECT_FALSE(queue.Find(0));
+    EXPECT_FALSE(queue.Remove(0));
+}
+
+//testing Insert/Find/Remove in one thread
+TEST_F(EmptyConcurrentQueue, InsertFindRemove) {
+    int value = 0;
+    queue.Insert(3);
+    queue.Insert(-7);
+    queue.Insert(3);
+    EXPECT_EQ(queue.Length(), 3);
+    ASSERT_TRUE(queue.GetHead(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_TRUE(queue.Find(-7));
+    EXPECT_FALSE(queue.Find(5));
+    //removing both values 3
+    EXPECT_TRUE(queue.Remove(3));
+    EXPECT_TRUE(queue.Remove(3));
+    EXPECT_FALSE(queue.Remove(3));
+    ASSERT_TRUE(queue.GetHead(value));
+    EXPECT_EQ(value, -7);
+    EXPECT_EQ(queue.Length(), 1);
+}
+
+//testing that PopMax empties queue and returns every value once
+TEST_F(EmptyConcurrentQueue, PopAll) {
+    for (int i = 0; i < 100; i++) {
+        queue.Insert(i % 10);
+    }
+    std::vector<int> counts(10, 0);
+    int value = 0;
+    while (queue.PopMax(value)) {
+        ASSERT_GE(value, 0);
+        ASSERT_LT(value, 10);
+        counts[value]++;
+    }
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(counts[i], 10);
+    }
+    EXPECT_EQ(queue.Length(), 0);
+}
+
+//producers insert distinct values and pop at the same time, at the end every
+//inserted value has to be popped exactly once
+TEST(ConcurrentQueueThreads, EveryValuePoppedOnce) {
+    const int threadCount = 8;
+    const int perThread = 5000;
+    ConcurrentPriorityQueue queue(threadCount);
+    std::vector<std::vector<int> > popped(threadCount);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread([&queue, &popped, t, perThread]() {
+            int value = 0;
+            for (int i = 0; i < perThread; i++) {
+                queue.Insert(t * perThread + i);
+                if (i % 2 == 1 && queue.PopMax(value)) {
+                    popped[t].push_back(value);
+                }
+                if (i % 100 == 0) {
+                    queue.Find(i);
+                }
+            }
+        }));
+    }
+    for (int t = 0; t < threadCount; t++) {
+        threads[t].join();
+    }
+
+    int value = 0;
+    while (queue.PopMax(value)) {
+        popped[0].push_back(value);
+    }
+
+    std::vector<int> counts(threadCount * perThread, 0);
+    for (int t = 0; t < threadCount; t++) {
+        for (size_t i = 0; i < popped[t].size(); i++) {
+            ASSERT_GE(popped[t][i], 0);
+            ASSERT_LT(popped[t][i], threadCount * perThread);
+            counts[popped[t][i]]++;
+        }
+    }
+    for (int i = 0; i < threadCount * perThread; i++) {
+        EXPECT_EQ(counts[i], 1) << "value " << i;
+    }
+    EXPECT_EQ(queue.Length(), 0);
+}
+
+//threads remove values inserted beforehand, every value is removed by exactly
+//one thread
+TEST(ConcurrentQueueThreads, ConcurrentRemove) {
+    const int threadCount = 4;
+    const int valueCount = 2000;
+    ConcurrentPriorityQueue queue(threadCount);
+    for (int i = 0; i < valueCount; i++) {
+        queue.Insert(i);
+    }
+
+    std::vector<int> removed(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread([&queue, &removed, t, valueCount]() {
+            //every thread tries to remove all values
+            for (int i = 0; i < valueCount; i++) {
+                if (queue.Remove((i + t * 500) % valueCount)) {
+                    removed[t]++;
+                }
+            }
+        }));
+    }
+    for (int t = 0; t < threadCount; t++) {
+        threads[t].join();
+    }
+
+    int total = 0;
+    for (int t = 0; t < threadCount; t++) {
+        total += removed[t];
+    }
+    EXPECT_EQ(total, valueCount);
+    EXPECT_EQ(queue.Length(), 0);
+}
+
+/*** Konec souboru concurrent_priority_queue_tests.cpp ***/
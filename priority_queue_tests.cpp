@@ -0,0 +1,672 @@
+//======== Copyright (c) 2021, FIT VUT Brno, All rights reserved. ============//
+//
+// Purpose:     Priority queue - extended interface tests
+//
+// $NoKeywords: $ivs_project_1 $priority_queue_tests.cpp
+// $Author:     Martin Kubicka <xkubic45@stud.fit.vutbr.cz>
+// $Date:       $2022-03-09
+//============================================================================//
+/**
+ * @file priority_queue_tests.cpp
+ * @author Martin Kubicka
+ *
+ * @brief Implementace testu rozsireneho rozhrani prioritni fronty.
+ */
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "tdd_code.h"
+
+//============================================================================//
+// Testy rozhrani BasicPriorityQueue, ktere nepokryva tdd_tests.cpp:
+// 1. Sablona - vlastni typ hodnoty, porovnani a data polozek.
+// 2. Hromadne operace - InsertRange, konstruktor z vektoru, PopTopK, DrainTo.
+// 3. Prace s polozkami - Erase, UpdatePriority, PopMax, hashovaci index.
+// 4. Iteratory.
+// 5. Velka fronta - index rozdeleny na vice useku.
+// 6. Vyjimky pri vkladani - fronta zustane beze zmeny.
+// 7. Automaticka kontrola konzistence (jen s PRIORITY_QUEUE_CHECK_CONSISTENCY).
+//============================================================================//
+
+//key type without std::hash
+struct Point {
+    int x;
+    int y;
+};
+
+//ordering points by x, then by y
+struct PointLess {
+    bool operator()(const Point &a, const Point &b) const {
+        return (a.x != b.x) ? a.x < b.x : a.y < b.y;
+    }
+};
+
+//test for queue with key without std::hash (queue works without value index)
+TEST(TemplateQueue, KeyWithoutHash) {
+    BasicPriorityQueue<Point, NoPayload, PointLess> queue;
+    Point a = { 1, 2 };
+    Point b = { 3, 0 };
+    Point c = { 1, 5 };
+    queue.Insert(a);
+    queue.Insert(b);
+    queue.Insert(c);
+    ASSERT_TRUE(queue.GetHead() != NULL);
+    EXPECT_EQ(queue.GetHead()->value.x, 3);
+    EXPECT_EQ(queue.GetHead()->pNext->value.y, 5);
+    EXPECT_TRUE(queue.Find(a) != NULL);
+    EXPECT_TRUE(queue.Remove(c));
+    EXPECT_FALSE(queue.Remove(c));
+    EXPECT_EQ(queue.Length(), 2);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for queue with std::pair key (std::hash<std::pair> doesnt exist)
+TEST(TemplateQueue, PairKey) {
+    BasicPriorityQueue<std::pair<int, int> > queue;
+    queue.Insert(std::make_pair(1, 1));
+    queue.Insert(std::make_pair(2, 0));
+    queue.Insert(std::make_pair(1, 3));
+    ASSERT_TRUE(queue.GetHead() != NULL);
+    EXPECT_EQ(queue.GetHead()->value, std::make_pair(2, 0));
+    EXPECT_TRUE(queue.Find(std::make_pair(1, 3)) != NULL);
+    EXPECT_TRUE(queue.Find(std::make_pair(0, 0)) == NULL);
+}
+
+//test for queue with hashable string key and value index
+TEST(TemplateQueue, StringKeyWithIndex) {
+    BasicPriorityQueue<std::string> queue;
+    queue.SetValueIndex(true);
+    queue.Insert("b");
+    queue.Insert("c");
+    queue.Insert("a");
+    ASSERT_TRUE(queue.GetHead() != NULL);
+    EXPECT_EQ(queue.GetHead()->value, "c");
+    EXPECT_TRUE(queue.Remove("c"));
+    EXPECT_EQ(queue.GetHead()->value, "b");
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for reversed ordering (head is the smallest value)
+TEST(TemplateQueue, GreaterCompare) {
+    BasicPriorityQueue<int, NoPayload, std::greater<int> > queue;
+    queue.Insert(5);
+    queue.Insert(1);
+    queue.Insert(9);
+    ASSERT_TRUE(queue.GetHead() != NULL);
+    EXPECT_EQ(queue.GetHead()->value, 1);
+    EXPECT_EQ(queue.GetHead()->pNext->value, 5);
+}
+
+//test for trivially copyable payload - moved and copied
+TEST(TemplateQueue, TrivialPayload) {
+    struct Job {
+        int id;
+        double weight;
+    };
+    BasicPriorityQueue<int, Job> queue;
+    Job job = { 7, 0.5 };
+    //copying lvalue payload
+    queue.Insert(2, job);
+    job.id = 8;
+    queue.Insert(4, std::move(job));
+    ASSERT_TRUE(queue.Find(2) != NULL);
+    EXPECT_EQ(queue.Find(2)->payload.id, 7);
+    EXPECT_EQ(queue.GetHead()->payload.id, 8);
+    EXPECT_EQ(queue.GetHead()->payload.weight, 0.5);
+}
+
+//test for move-only payload
+TEST(TemplateQueue, MoveOnlyPayload) {
+    BasicPriorityQueue<int, std::unique_ptr<std::string> > queue;
+    queue.Insert(1, std::unique_ptr<std::string>(new std::string("one")));
+    queue.Insert(3, std::unique_ptr<std::string>(new std::string("three")));
+    queue.Insert(2);
+    ASSERT_TRUE(queue.GetHead() != NULL);
+    EXPECT_EQ(*queue.GetHead()->payload, "three");
+    EXPECT_TRUE(queue.Find(2)->payload == NULL);
+    //removed payload is destroyed, rest is destroyed with queue
+    EXPECT_TRUE(queue.Remove(3));
+    EXPECT_EQ(*queue.GetHead()->pNext->payload, "one");
+}
+
+//values in queue in order max->min (walking list)
+template <typename Queue>
+static std::vector<int> ListValues(Queue &queue)
+{
+    std::vector<int> values;
+    for (typename Queue::Element_t *node = queue.GetHead(); node != NULL; node = node->pNext) {
+        values.push_back(node->value);
+    }
+    return values;
+}
+
+class BatchQueue : public ::testing::Test
+{
+protected:
+    void SetUp() {
+        int values[] = { 5, 1, 9, 3, 5, 7 };
+        queue.InsertRange(values, values + 6);
+    }
+
+    PriorityQueue queue;
+};
+
+//test for InsertRange into empty queue
+TEST_F(BatchQueue, InsertRange) {
+    int expected[] = { 9, 7, 5, 5, 3, 1 };
+    EXPECT_EQ(ListValues(queue), std::vector<int>(expected, expected + 6));
+    EXPECT_EQ(queue.Length(), 6);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for InsertRange merged with nonempty queue
+TEST_F(BatchQueue, InsertRangeMerge) {
+    std::vector<int> values;
+    values.push_back(10);
+    values.push_back(5);
+    values.push_back(0);
+    queue.InsertRange(values.begin(), values.end());
+    int expected[] = { 10, 9, 7, 5, 5, 5, 3, 1, 0 };
+    EXPECT_EQ(ListValues(queue), std::vector<int>(expected, expected + 9));
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //empty range doesnt change queue
+    queue.InsertRange(values.begin(), values.begin());
+    EXPECT_EQ(queue.Length(), 9);
+}
+
+//test for constructor from vector
+TEST(BatchQueueConstructor, FromVector) {
+    std::vector<int> values;
+    values.push_back(2);
+    values.push_back(8);
+    values.push_back(2);
+    PriorityQueue queue(values);
+    int expected[] = { 8, 2, 2 };
+    EXPECT_EQ(ListValues(queue), std::vector<int>(expected, expected + 3));
+    EXPECT_TRUE(queue.IsConsistent());
+
+    PriorityQueue empty((std::vector<int>()));
+    EXPECT_TRUE(empty.GetHead() == NULL);
+    EXPECT_EQ(empty.Length(), 0);
+}
+
+//test for PopTopK - less and more items than in queue
+TEST_F(BatchQueue, PopTopK) {
+    int out[10];
+    EXPECT_EQ(queue.PopTopK(0, out), 0);
+    EXPECT_EQ(queue.PopTopK(2, out), 2);
+    EXPECT_EQ(out[0], 9);
+    EXPECT_EQ(out[1], 7);
+    EXPECT_EQ(queue.GetHead()->value, 5);
+    EXPECT_TRUE(queue.IsConsistent());
+
+    EXPECT_EQ(queue.PopTopK(10, out), 4);
+    EXPECT_EQ(out[3], 1);
+    EXPECT_TRUE(queue.GetHead() == NULL);
+    EXPECT_EQ(queue.Length(), 0);
+    EXPECT_EQ(queue.PopTopK(1, out), 0);
+}
+
+//test for DrainTo - items are appended, queue is empty
+TEST_F(BatchQueue, DrainTo) {
+    std::vector<int> values(1, 42);
+    EXPECT_EQ(queue.DrainTo(values), 6);
+    int expected[] = { 42, 9, 7, 5, 5, 3, 1 };
+    EXPECT_EQ(values, std::vector<int>(expected, expected + 7));
+    EXPECT_TRUE(queue.GetHead() == NULL);
+    EXPECT_EQ(queue.Length(), 0);
+
+    //queue is usable after draining
+    queue.Insert(4);
+    EXPECT_EQ(queue.GetHead()->value, 4);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for PopTopK and DrainTo returning payloads
+TEST(BatchQueuePayload, PopTopKAndDrainTo) {
+    BasicPriorityQueue<int, std::unique_ptr<std::string> > queue;
+    queue.Insert(1, std::unique_ptr<std::string>(new std::string("one")));
+    queue.Insert(3, std::unique_ptr<std::string>(new std::string("three")));
+    queue.Insert(2, std::unique_ptr<std::string>(new std::string("two")));
+
+    int out[1];
+    std::unique_ptr<std::string> payloads[1];
+    EXPECT_EQ(queue.PopTopK(1, out, payloads), 1);
+    EXPECT_EQ(out[0], 3);
+    ASSERT_TRUE(payloads[0] != NULL);
+    EXPECT_EQ(*payloads[0], "three");
+
+    std::vector<int> values;
+    std::vector<std::unique_ptr<std::string> > rest;
+    EXPECT_EQ(queue.DrainTo(values, rest), 2);
+    ASSERT_EQ(rest.size(), 2);
+    EXPECT_EQ(values[0], 2);
+    EXPECT_EQ(*rest[0], "two");
+    EXPECT_EQ(*rest[1], "one");
+}
+
+class HandleQueue : public ::testing::Test
+{
+protected:
+    void SetUp() {
+        for (int i = 0; i < 5; i++) {
+            handles[i] = queue.Insert(i * 10);
+        }
+    }
+
+    PriorityQueue queue;
+    PriorityQueue::Element_t *handles[5];
+};
+
+//test for Erase - first, middle and last item
+TEST_F(HandleQueue, Erase) {
+    queue.Erase(handles[4]);
+    queue.Erase(handles[2]);
+    queue.Erase(handles[0]);
+    int expected[] = { 30, 10 };
+    EXPECT_EQ(ListValues(queue), std::vector<int>(expected, expected + 2));
+    EXPECT_EQ(queue.Length(), 2);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for Erase of one of items with the same value
+TEST_F(HandleQueue, EraseDuplicate) {
+    PriorityQueue::Element_t *second = queue.Insert(20);
+    queue.Erase(handles[2]);
+    EXPECT_EQ(queue.Find(20), second);
+    EXPECT_EQ(queue.Length(), 5);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for UpdatePriority - item moves, handle stays valid
+TEST_F(HandleQueue, UpdatePriority) {
+    queue.UpdatePriority(handles[0], 25);
+    EXPECT_EQ(handles[0]->value, 25);
+    int expected[] = { 40, 30, 25, 20, 10 };
+    EXPECT_EQ(ListValues(queue), std::vector<int>(expected, expected + 5));
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //moving to the head and to the end
+    queue.UpdatePriority(handles[1], 50);
+    EXPECT_EQ(queue.GetHead(), handles[1]);
+    queue.UpdatePriority(handles[4], -1);
+    EXPECT_EQ(queue.GetHead()->value, 50);
+    EXPECT_EQ(ListValues(queue).back(), -1);
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //same value
+    queue.UpdatePriority(handles[3], 30);
+    EXPECT_EQ(queue.Length(), 5);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for PopMax until queue is empty
+TEST_F(HandleQueue, PopMax) {
+    int value = -1;
+    for (int i = 4; i >= 0; i--) {
+        EXPECT_TRUE(queue.PopMax(value));
+        EXPECT_EQ(value, i * 10);
+    }
+    EXPECT_FALSE(queue.PopMax(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.GetHead() == NULL);
+}
+
+//test for PopMax with payload
+TEST(HandleQueuePayload, PopMax) {
+    BasicPriorityQueue<int, std::string> queue;
+    queue.Insert(1, std::string("one"));
+    queue.Insert(2, std::string("two"));
+    int value = 0;
+    std::string payload;
+    EXPECT_TRUE(queue.PopMax(value, payload));
+    EXPECT_EQ(value, 2);
+    EXPECT_EQ(payload, "two");
+    EXPECT_TRUE(queue.PopMax(value, payload));
+    EXPECT_EQ(payload, "one");
+    EXPECT_FALSE(queue.PopMax(value, payload));
+}
+
+//test for operations with value index turned on
+TEST_F(HandleQueue, ValueIndex) {
+    queue.SetValueIndex(true);
+    EXPECT_TRUE(queue.IsConsistent());
+    EXPECT_EQ(queue.Find(30), handles[3]);
+    EXPECT_TRUE(queue.Find(35) == NULL);
+    EXPECT_FALSE(queue.Remove(35));
+
+    queue.Insert(30);
+    EXPECT_TRUE(queue.Remove(30));
+    EXPECT_TRUE(queue.Find(30) != NULL);
+    EXPECT_TRUE(queue.Remove(30));
+    EXPECT_TRUE(queue.Find(30) == NULL);
+
+    queue.UpdatePriority(handles[0], 45);
+    EXPECT_EQ(queue.Find(45), handles[0]);
+    EXPECT_TRUE(queue.Find(0) == NULL);
+    queue.Erase(handles[1]);
+    EXPECT_TRUE(queue.Find(10) == NULL);
+
+    int out[2];
+    EXPECT_EQ(queue.PopTopK(2, out), 2);
+    EXPECT_TRUE(queue.Find(45) == NULL);
+    EXPECT_EQ(queue.Find(20), handles[2]);
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //turning off keeps queue usable
+    queue.SetValueIndex(false);
+    EXPECT_EQ(queue.Find(20), handles[2]);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//test for iterating max->min, same order as list
+TEST_F(BatchQueue, Iterator) {
+    std::vector<int> values;
+    for (PriorityQueue::iterator it = queue.begin(); it != queue.end(); ++it) {
+        values.push_back(it->value);
+    }
+    EXPECT_EQ(values, ListValues(queue));
+
+    //walking backwards from end
+    PriorityQueue::iterator it = queue.end();
+    --it;
+    EXPECT_EQ(it->value, 1);
+    EXPECT_EQ((*queue.begin()).value, 9);
+    EXPECT_EQ(&*queue.begin(), queue.GetHead());
+}
+
+//test for iterating const queue - const_iterator gives only const items
+TEST_F(BatchQueue, ConstIterator) {
+    static_assert(std::is_const<std::remove_reference<PriorityQueue::const_iterator::reference>::type>::value,
+                  "const_iterator must not give mutable items");
+    const PriorityQueue &constQueue = queue;
+    std::vector<int> values;
+    for (PriorityQueue::const_iterator it = constQueue.begin(); it != constQueue.end(); ++it) {
+        values.push_back(it->value);
+    }
+    EXPECT_EQ(values, ListValues(queue));
+
+    //iterator converts to const_iterator
+    PriorityQueue::const_iterator it = queue.begin();
+    EXPECT_EQ(it->value, 9);
+}
+
+//test for iterating only values max->min
+TEST_F(BatchQueue, Values) {
+    std::vector<int> values;
+    for (const int &value : queue.Values()) {
+        values.push_back(value);
+    }
+    EXPECT_EQ(values, ListValues(queue));
+
+    //walking backwards from end
+    PriorityQueue::ValueIterator it = queue.Values().end();
+    EXPECT_EQ(*--it, 1);
+    EXPECT_EQ(*queue.Values().begin(), 9);
+}
+
+//test for iterating empty queue
+TEST(EmptyIterator, Empty) {
+    PriorityQueue queue;
+    EXPECT_TRUE(queue.begin() == queue.end());
+    EXPECT_TRUE(queue.Values().begin() == queue.Values().end());
+}
+
+//test for queue big enough to split index into many chunks and merge them
+//again while it is shrinking
+TEST(LargeQueue, SplitAndMerge) {
+    const int count = 5000;
+    PriorityQueue queue;
+    std::vector<PriorityQueue::Element_t *> handles;
+    for (int i = 0; i < count; i++) {
+        //values are inserted in mixed order, every value twice
+        handles.push_back(queue.Insert((i * 7919) % (count / 2)));
+    }
+    EXPECT_EQ(queue.Length(), count);
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //moving every fourth item to the top
+    for (int i = 0; i < count; i += 4) {
+        queue.UpdatePriority(handles[i], count + i);
+    }
+    EXPECT_EQ(queue.GetHead(), handles[count - 4]);
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //values go over all chunks in the same order as list
+    std::vector<int> values(queue.Values().begin(), queue.Values().end());
+    EXPECT_EQ(values, ListValues(queue));
+
+    //erasing all odd handles
+    for (int i = 1; i < count; i += 2) {
+        queue.Erase(handles[i]);
+    }
+    EXPECT_EQ(queue.Length(), count / 2);
+    EXPECT_TRUE(queue.IsConsistent());
+
+    //popping until queue is empty, values come from max to min
+    int previous = count * 2;
+    int value = 0;
+    while (queue.PopMax(value)) {
+        EXPECT_LE(value, previous);
+        previous = value;
+    }
+    EXPECT_EQ(queue.Length(), 0);
+    EXPECT_TRUE(queue.GetHead() == NULL);
+    EXPECT_TRUE(queue.IsConsistent());
+}
+
+//copies of ThrowingKey/ThrowingPayload left before next one throws (-1 never)
+static int copiesLeft = -1;
+
+//throwing when copiesLeft runs out
+static void CountCopy()
+{
+    if (copiesLeft == 0) {
+        throw std::runtime_error("copy");
+    }
+    if (copiesLeft > 0) {
+        copiesLeft--;
+    }
+}
+
+//key with value on heap, its copy can throw (move cant)
+struct ThrowingKey {
+    int value;
+    std::string text;
+
+    ThrowingKey(int v) : value(v), text(std::to_string(v) + " - long enough to be on heap") {}
+    ThrowingKey(const ThrowingKey &other) : value(other.value), text(other.text) { CountCopy(); }
+    ThrowingKey(ThrowingKey &&other) noexcept : value(other.value), text(std::move(other.text)) {}
+    ThrowingKey &operator=(const ThrowingKey &other) {
+        CountCopy();
+        value = other.value;
+        text = other.text;
+        return *this;
+    }
+    ThrowingKey &operator=(ThrowingKey &&other) noexcept {
+        value = other.value;
+        text = std::move(other.text);
+        return *this;
+    }
+};
+
+//value index compares keys with ==
+static bool operator==(const ThrowingKey &a, const ThrowingKey &b)
+{
+    return a.value == b.value;
+}
+
+struct ThrowingKeyLess {
+    bool operator()(const ThrowingKey &a, const ThrowingKey &b) const { return a.value < b.value; }
+};
+
+struct ThrowingKeyHash {
+    size_t operator()(const ThrowingKey &key) const { return std::hash<int>()(key.value); }
+};
+
+//payload which can throw while it is moved into queue
+struct ThrowingPayload {
+    std::string text;
+
+    ThrowingPayload() {}
+    ThrowingPayload(const std::string &t) : text(t) {}
+    ThrowingPayload(ThrowingPayload &&other) : text(other.text) {
+        CountCopy();
+        other.text.clear();
+    }
+    ThrowingPayload &operator=(ThrowingPayload &&other) {
+        CountCopy();
+        text = other.text;
+        other.text.clear();
+        return *this;
+    }
+};
+
+typedef BasicPriorityQueue<ThrowingKey, ThrowingPayload, ThrowingKeyLess, ThrowingKeyHash> ThrowingQueue;
+
+//values in queue in order max->min (walking list)
+static std::vector<int> ThrowingValues(ThrowingQueue &queue)
+{
+    std::vector<int> values;
+    for (ThrowingQueue::Element_t *node = queue.GetHead(); node != NULL; node = node->pNext) {
+        values.push_back(node->value.value);
+    }
+    return values;
+}
+
+//queue with so many values that inserting splits chunk of index
+class ThrowingInsert : public ::testing::TestWithParam<bool>
+{
+protected:
+    void SetUp() {
+        copiesLeft = -1;
+        queue.SetValueIndex(GetParam());
+        for (int i = 0; i < 600; i++) {
+            handles.push_back(queue.Insert(ThrowingKey(i % 300)));
+        }
+        before = ThrowingValues(queue);
+    }
+
+    void TearDown() {
+        copiesLeft = -1;
+    }
+
+    //checking that queue is the same as after SetUp
+    void ExpectUnchanged() {
+        EXPECT_EQ(queue.Length(), (int)before.size());
+        EXPECT_TRUE(queue.IsConsistent());
+        EXPECT_EQ(ThrowingValues(queue), before);
+    }
+
+    ThrowingQueue queue;
+    std::vector<ThrowingQueue::Element_t *> handles;
+    std::vector<int> before;
+};
+
+//test for Insert failing on every copy of value or payload
+TEST_P(ThrowingInsert, Insert) {
+    for (int throwAt = 0;; throwAt++) {
+        ThrowingPayload payload("payload");
+        copiesLeft = throwAt;
+        try {
+            queue.Insert(ThrowingKey(150), std::move(payload));
+        } catch (const std::runtime_error &) {
+            copiesLeft = -1;
+            ExpectUnchanged();
+            //payload stays to caller
+            EXPECT_EQ(payload.text, "payload");
+            continue;
+        }
+        copiesLeft = -1;
+        EXPECT_EQ(queue.Length(), (int)before.size() + 1);
+        EXPECT_EQ(queue.Find(ThrowingKey(150))->value.value, 150);
+        EXPECT_TRUE(queue.IsConsistent());
+        break;
+    }
+}
+
+//test for InsertRange failing on every copy of value
+TEST_P(ThrowingInsert, InsertRange) {
+    std::vector<ThrowingKey> values;
+    for (int i = 0; i < 300; i++) {
+        values.push_back(ThrowingKey(1000 - i));
+    }
+    for (int throwAt = 0;; throwAt += 37) {
+        copiesLeft = throwAt;
+        try {
+            queue.InsertRange(values.begin(), values.end());
+        } catch (const std::runtime_error &) {
+            copiesLeft = -1;
+            ExpectUnchanged();
+            continue;
+        }
+        copiesLeft = -1;
+        EXPECT_EQ(queue.Length(), (int)before.size() + 300);
+        EXPECT_EQ(queue.GetHead()->value.value, 1000);
+        EXPECT_TRUE(queue.IsConsistent());
+        break;
+    }
+}
+
+//test for UpdatePriority failing on every copy of value
+TEST_P(ThrowingInsert, UpdatePriority) {
+    for (int throwAt = 0;; throwAt++) {
+        copiesLeft = throwAt;
+        try {
+            queue.UpdatePriority(handles[10], ThrowingKey(1000));
+        } catch (const std::runtime_error &) {
+            copiesLeft = -1;
+            ExpectUnchanged();
+            continue;
+        }
+        copiesLeft = -1;
+        EXPECT_EQ(queue.GetHead(), handles[10]);
+        EXPECT_TRUE(queue.IsConsistent());
+        break;
+    }
+}
+
+//test for Insert failing in empty queue
+TEST(ThrowingInsertEmpty, Insert) {
+    ThrowingQueue queue;
+    copiesLeft = 0;
+    EXPECT_THROW(queue.Insert(ThrowingKey(1)), std::runtime_error);
+    copiesLeft = -1;
+    EXPECT_EQ(queue.Length(), 0);
+    EXPECT_TRUE(queue.GetHead() == NULL);
+    EXPECT_TRUE(queue.IsConsistent());
+    EXPECT_TRUE(queue.begin() == queue.end());
+}
+
+INSTANTIATE_TEST_CASE_P(ValueIndex, ThrowingInsert, ::testing::Values(false, true));
+
+#if defined(PRIORITY_QUEUE_CHECK_CONSISTENCY) && !defined(NDEBUG)
+//queue whose length can be broken from outside
+class BrokenQueue : public PriorityQueue
+{
+public:
+    void BreakLength() { m_length++; }
+};
+
+//test for check after every change - broken queue stops at next change
+TEST(ConsistencyCheck, BrokenQueue) {
+    BrokenQueue queue;
+    queue.Insert(1);
+    queue.Insert(2);
+    EXPECT_TRUE(queue.Remove(1));
+    queue.BreakLength();
+    EXPECT_DEATH(queue.Insert(3), "IsConsistent");
+    EXPECT_DEATH(queue.Remove(2), "IsConsistent");
+    EXPECT_DEATH(queue.Erase(queue.GetHead()), "IsConsistent");
+}
+#endif
+
+/*** Konec souboru priority_queue_tests.cpp ***/
@@ -0,0 +1,535 @@
+//======== Copyright (c) 2021, FIT VUT Brno, All rights reserved. ============//
+//
+// Purpose:     Test Driven Development - priority queue benchmarks
+//
+// $NoKeywords: $ivs_project_1 $tdd_benchmarks.cpp
+// $Author:     Martin Kubicka <xkubic45@stud.fit.vutbr.cz>
+// $Date:       $2022-03-09
+//============================================================================//
+/**
+ * @file tdd_benchmarks.cpp
+ * @author Martin Kubicka
+ *
+ * @brief Mereni rychlosti prioritni fronty (vysledky se vypisuji na stdout).
+ * Preklada se spolu s tdd_code.cpp a concurrent_priority_queue.cpp.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "tdd_code.h"
+#include "concurrent_priority_queue.h"
+
+//============================================================================//
+// Benchmarky porovnavaji PriorityQueue s puvodni implementaci pomoci
+// "singly linked list" (ListQueue nize). Kazdy benchmark vypise tabulku casu
+// a overi, ze obe implementace daly stejny vysledek. Merit ma smysl jen
+// v prekladu s optimalizacemi a s -DNDEBUG.
+//============================================================================//
+
+//original linked list queue - every insert walks the list, every node is
+//allocated by new
+class ListQueue
+{
+public:
+    ListQueue() : m_pHead(NULL), m_length(0) {}
+
+    ~ListQueue() {
+        while (m_pHead != NULL) {
+            Node_t *next = m_pHead->pNext;
+            delete m_pHead;
+            m_pHead = next;
+        }
+    }
+
+    void Insert(int value) {
+        Node_t *node = new Node_t;
+        node->value = value;
+        //node goes behind nodes with bigger or same value
+        Node_t **pLink = &m_pHead;
+        while (*pLink != NULL && (*pLink)->value >= value) {
+            pLink = &(*pLink)->pNext;
+        }
+        node->pNext = *pLink;
+        *pLink = node;
+        m_length++;
+    }
+
+    bool Remove(int value) {
+        for (Node_t **pLink = &m_pHead; *pLink != NULL; pLink = &(*pLink)->pNext) {
+            if ((*pLink)->value == value) {
+                Node_t *tmp = *pLink;
+                *pLink = tmp->pNext;
+                delete tmp;
+                m_length--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t Length() const { return m_length; }
+
+    //walking whole list
+    long long Sum() const {
+        long long sum = 0;
+        for (const Node_t *node = m_pHead; node != NULL; node = node->pNext) {
+            sum += node->value;
+        }
+        return sum;
+    }
+
+private:
+    struct Node_t {
+        Node_t *pNext;
+        int value;
+    };
+
+    Node_t *m_pHead;
+    size_t m_length;
+};
+
+//measuring time of function call in milliseconds
+template <typename Function>
+static double MeasureMs(Function function)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//generating "count" random values
+static std::vector<int> RandomValues(size_t count, int range)
+{
+    std::vector<int> values(count);
+    for (size_t i = 0; i < count; i++) {
+        values[i] = rand() % range;
+    }
+    return values;
+}
+
+//inserting n random values into empty queue - list walks nodes (O(n) per
+//insert), queue searches chunks of index and shifts entries of one chunk
+//(O(log n + INDEX_CHUNK_SIZE)); list is too slow to be measured for big n
+TEST(PriorityQueueBenchmark, InsertCrossover) {
+    srand(1);
+    const size_t listLimit = 16384;
+    std::vector<size_t> sizes;
+    for (size_t n = 4; n <= listLimit; n *= 2) {
+        sizes.push_back(n);
+    }
+    sizes.push_back(100000);
+    sizes.push_back(1000000);
+
+    printf("%10s %16s %16s\n", "n", "list [ns/insert]", "index [ns/insert]");
+    for (size_t s = 0; s < sizes.size(); s++) {
+        size_t n = sizes[s];
+        std::vector<int> values = RandomValues(n, 1000000);
+        //small queues are measured more times
+        size_t repeats = 65536 / n + 1;
+
+        double listMs = 0.0;
+        if (n <= listLimit) {
+            size_t listLength = 0;
+            listMs = MeasureMs([&]() {
+                for (size_t r = 0; r < repeats; r++) {
+                    ListQueue queue;
+                    for (size_t i = 0; i < n; i++) {
+                        queue.Insert(values[i]);
+                    }
+                    listLength += queue.Length();
+                }
+            });
+            EXPECT_EQ(listLength, n * repeats);
+        }
+
+        size_t queueLength = 0;
+        double queueMs = MeasureMs([&]() {
+            for (size_t r = 0; r < repeats; r++) {
+                PriorityQueue queue;
+                for (size_t i = 0; i < n; i++) {
+                    queue.Insert(values[i]);
+                }
+                queueLength += queue.Length();
+            }
+        });
+
+        EXPECT_EQ(queueLength, n * repeats);
+        double inserts = (double)(n * repeats);
+        if (n <= listLimit) {
+            printf("%10zu %16.1f %16.1f\n", n, listMs * 1e6 / inserts, queueMs * 1e6 / inserts);
+        } else {
+            printf("%10zu %16s %16.1f\n", n, "-", queueMs * 1e6 / inserts);
+        }
+    }
+}
+
+//queue with access to its node pool
+class PoolProbe : public PriorityQueue
+{
+public:
+    using PriorityQueue::AllocElement;
+    using PriorityQueue::FreeElement;
+};
+
+//keeping "live" nodes allocated and replacing random one in every step, once
+//with pool of the queue and once with new/delete
+TEST(PriorityQueueBenchmark, PoolChurn) {
+    srand(2);
+    const size_t steps = 2000000;
+    printf("%10s %16s %16s\n", "live", "new [ns/step]", "pool [ns/step]");
+    for (size_t live = 64; live <= 262144; live *= 8) {
+        std::vector<size_t> victims(steps);
+        for (size_t i = 0; i < steps; i++) {
+            victims[i] = (size_t)rand() % live;
+        }
+
+        long long newSum = 0;
+        double newMs = MeasureMs([&]() {
+            std::vector<PriorityQueue::Element_t *> nodes(live);
+            for (size_t i = 0; i < live; i++) {
+                nodes[i] = new PriorityQueue::Element_t;
+                nodes[i]->value = (int)i;
+            }
+            for (size_t i = 0; i < steps; i++) {
+                PriorityQueue::Element_t *&node = nodes[victims[i]];
+                newSum += node->value;
+                delete node;
+                node = new PriorityQueue::Element_t;
+                node->value = (int)i;
+            }
+            for (size_t i = 0; i < live; i++) {
+                delete nodes[i];
+            }
+        });
+
+        long long poolSum = 0;
+        double poolMs = MeasureMs([&]() {
+            PoolProbe pool;
+            std::vector<PriorityQueue::Element_t *> nodes(live);
+            for (size_t i = 0; i < live; i++) {
+                nodes[i] = pool.AllocElement();
+                nodes[i]->value = (int)i;
+            }
+            for (size_t i = 0; i < steps; i++) {
+                PriorityQueue::Element_t *&node = nodes[victims[i]];
+                poolSum += node->value;
+                pool.FreeElement(node);
+                node = pool.AllocElement();
+                node->value = (int)i;
+            }
+            //nodes are released with whole blocks
+        });
+
+        EXPECT_EQ(newSum, poolSum);
+        printf("%10zu %16.1f %16.1f\n", live, newMs * 1e6 / steps, poolMs * 1e6 / steps);
+    }
+}
+
+//queue with "live" items, every step inserts one value and removes other one
+TEST(PriorityQueueBenchmark, InsertRemoveChurn) {
+    srand(3);
+    const size_t steps = 50000;
+    printf("%10s %16s %16s\n", "live", "list [ns/step]", "queue [ns/step]");
+    for (size_t live = 16; live <= 4096; live *= 4) {
+        std::vector<int> values = RandomValues(live + steps, 1000000);
+
+        ListQueue list;
+        double listMs = MeasureMs([&]() {
+            for (size_t i = 0; i < live; i++) {
+                list.Insert(values[i]);
+            }
+            for (size_t i = 0; i < steps; i++) {
+                list.Insert(values[live + i]);
+                list.Remove(values[i]);
+            }
+        });
+
+        PriorityQueue queue;
+        double queueMs = MeasureMs([&]() {
+            for (size_t i = 0; i < live; i++) {
+                queue.Insert(values[i]);
+            }
+            for (size_t i = 0; i < steps; i++) {
+                queue.Insert(values[live + i]);
+                queue.Remove(values[i]);
+            }
+        });
+
+        EXPECT_EQ(list.Length(), queue.Length());
+        printf("%10zu %16.1f %16.1f\n", live, listMs * 1e6 / steps, queueMs * 1e6 / steps);
+    }
+}
+
+//queue with "live" items, every step inserts one value and cancels three
+//values - one pending and two which are not in queue (negative values)
+TEST(PriorityQueueBenchmark, CancelHeavy) {
+    srand(4);
+    const size_t steps = 20000;
+    printf("%10s %16s %16s %16s\n", "live", "list [ns/step]", "index [ns/step]", "hash [ns/step]");
+    //list is too slow for bigger queues
+    const size_t listLimit = 4096;
+    for (size_t live = 64; live <= 262144; live *= 4) {
+        std::vector<int> values = RandomValues(live + steps, 100000000);
+
+        //precomputing cancels, so queue length stays "live"
+        std::vector<int> pending(values.begin(), values.begin() + live);
+        std::vector<int> cancels(3 * steps);
+        for (size_t i = 0; i < steps; i++) {
+            pending.push_back(values[live + i]);
+            size_t victim = (size_t)rand() % pending.size();
+            cancels[3 * i] = pending[victim];
+            pending[victim] = pending.back();
+            pending.pop_back();
+            cancels[3 * i + 1] = -1 - rand() % 100000000;
+            cancels[3 * i + 2] = -1 - rand() % 100000000;
+        }
+
+        size_t listRemoved = steps;
+        double listMs = -1.0;
+        if (live <= listLimit) {
+            listRemoved = 0;
+            ListQueue list;
+            listMs = MeasureMs([&]() {
+                for (size_t i = 0; i < live; i++) {
+                    list.Insert(values[i]);
+                }
+                for (size_t i = 0; i < steps; i++) {
+                    list.Insert(values[live + i]);
+                    for (size_t j = 3 * i; j < 3 * i + 3; j++) {
+                        listRemoved += list.Remove(cancels[j]);
+                    }
+                }
+            });
+        }
+
+        size_t removed[2] = { 0, 0 };
+        double queueMs[2];
+        for (int useHash = 0; useHash < 2; useHash++) {
+            PriorityQueue queue;
+            queue.SetValueIndex(useHash != 0);
+            queueMs[useHash] = MeasureMs([&]() {
+                for (size_t i = 0; i < live; i++) {
+                    queue.Insert(values[i]);
+                }
+                for (size_t i = 0; i < steps; i++) {
+                    queue.Insert(values[live + i]);
+                    for (size_t j = 3 * i; j < 3 * i + 3; j++) {
+                        if (queue.Find(cancels[j]) != NULL) {
+                            removed[useHash] += queue.Remove(cancels[j]);
+                        }
+                    }
+                }
+            });
+            EXPECT_EQ(live, queue.Length());
+        }
+
+        EXPECT_EQ(steps, listRemoved);
+        EXPECT_EQ(listRemoved, removed[0]);
+        EXPECT_EQ(listRemoved, removed[1]);
+        if (listMs < 0.0) {
+            printf("%10zu %16s %16.1f %16.1f\n", live, "-", queueMs[0] * 1e6 / steps, queueMs[1] * 1e6 / steps);
+        } else {
+            printf("%10zu %16.1f %16.1f %16.1f\n", live, listMs * 1e6 / steps,
+                   queueMs[0] * 1e6 / steps, queueMs[1] * 1e6 / steps);
+        }
+    }
+}
+
+//queue with n handles and only few priority levels (like scheduler), every
+//step moves random handle to random level - handle is found by value and
+//address, so long runs of same values dont slow it down
+TEST(PriorityQueueBenchmark, UpdatePriorityLevels) {
+    srand(7);
+    const size_t steps = 200000;
+    printf("%10s %16s %16s\n", "handles", "4 levels [ns]", "1M levels [ns]");
+    for (size_t n = 1000; n <= 1000000; n *= 10) {
+        double ms[2];
+        const int levels[2] = { 4, 1000000 };
+        for (int l = 0; l < 2; l++) {
+            PriorityQueue queue;
+            std::vector<PriorityQueue::Element_t *> handles(n);
+            for (size_t i = 0; i < n; i++) {
+                handles[i] = queue.Insert(rand() % levels[l]);
+            }
+            std::vector<size_t> victims(steps);
+            std::vector<int> values(steps);
+            for (size_t i = 0; i < steps; i++) {
+                victims[i] = (size_t)rand() % n;
+                values[i] = rand() % levels[l];
+            }
+
+            ms[l] = MeasureMs([&]() {
+                for (size_t i = 0; i < steps; i++) {
+                    queue.UpdatePriority(handles[victims[i]], values[i]);
+                }
+            });
+            EXPECT_EQ(queue.Length(), n);
+            EXPECT_TRUE(queue.IsConsistent());
+        }
+        printf("%10zu %16.1f %16.1f\n", n, ms[0] * 1e6 / steps, ms[1] * 1e6 / steps);
+    }
+}
+
+//deterministic pseudo random value for thread "t" and step "i"
+static int ScatteredValue(int t, int i)
+{
+    return (int)(((long long)t * 7919 + (long long)i * 104729) % 1000003);
+}
+
+//running "threadCount" threads, each calls "work(thread)" once
+template <typename Work>
+static double MeasureThreadsMs(int threadCount, Work work)
+{
+    return MeasureMs([&]() {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++) {
+            threads.push_back(std::thread(work, t));
+        }
+        for (int t = 0; t < threadCount; t++) {
+            threads[t].join();
+        }
+    });
+}
+
+//queue prefilled with 4096 values, every thread inserts value and pops max
+//in every step, once with one PriorityQueue behind global mutex and once with
+//ConcurrentPriorityQueue
+TEST(PriorityQueueBenchmark, ConcurrentThroughput) {
+    const int perThread = 100000;
+    const int prefill = 4096;
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 4) {
+        maxThreads = 4;
+    }
+    printf("(hardware threads: %u)\n", std::thread::hardware_concurrency());
+    printf("%10s %16s %16s\n", "threads", "mutex [Mops/s]", "sharded [Mops/s]");
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        double operations = 2.0 * perThread * threadCount;
+
+        std::mutex lock;
+        PriorityQueue locked;
+        ConcurrentPriorityQueue sharded;
+        for (int i = 0; i < prefill; i++) {
+            locked.Insert(ScatteredValue(0, i));
+            sharded.Insert(ScatteredValue(0, i));
+        }
+
+        double lockedMs = MeasureThreadsMs(threadCount, [&](int t) {
+            int value = 0;
+            for (int i = 0; i < perThread; i++) {
+                std::lock_guard<std::mutex> guard(lock);
+                locked.Insert(ScatteredValue(t + 1, i));
+                locked.PopMax(value);
+            }
+        });
+
+        double shardedMs = MeasureThreadsMs(threadCount, [&](int t) {
+            int value = 0;
+            for (int i = 0; i < perThread; i++) {
+                sharded.Insert(ScatteredValue(t + 1, i));
+                sharded.PopMax(value);
+            }
+        });
+
+        EXPECT_EQ(locked.Length(), sharded.Length());
+        printf("%10d %16.2f %16.2f\n", threadCount, operations / lockedMs / 1e3, operations / shardedMs / 1e3);
+    }
+}
+
+//walking all items of queue with n items - original list, list of queue
+//through pNext, queue iterators and only values of queue; small queue is
+//walked repeatedly, so every size reads 10M items in total. Queue is walked
+//bulk loaded (nodes lie in blocks in order of values) and churned (inserted
+//one by one and every handle moved once - nodes lie in blocks randomly)
+TEST(PriorityQueueBenchmark, FullScan) {
+    srand(6);
+    const size_t total = 10000000;
+    printf("%10s %8s %16s %16s %16s %16s\n", "n", "queue", "list [ns/item]", "pNext [ns/item]",
+           "iter [ns/item]", "values [ns/item]");
+    const size_t sizes[] = { 10000, 1000000, 10000000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        size_t repeats = total / n;
+        std::vector<int> values = RandomValues(n, 1000000);
+
+        //ascending values are always inserted at the head - O(1) per insert
+        std::vector<int> sorted(values);
+        std::sort(sorted.begin(), sorted.end());
+        ListQueue list;
+        for (size_t i = 0; i < n; i++) {
+            list.Insert(sorted[i]);
+        }
+        long long listSum = 0;
+        double listMs = MeasureMs([&]() {
+            for (size_t r = 0; r < repeats; r++) {
+                listSum += list.Sum();
+            }
+        });
+
+        for (int churned = 0; churned < 2; churned++) {
+            PriorityQueue queue;
+            if (churned) {
+                std::vector<PriorityQueue::Element_t *> handles;
+                handles.reserve(n);
+                for (size_t i = 0; i < n; i++) {
+                    handles.push_back(queue.Insert(values[i]));
+                }
+                std::random_shuffle(handles.begin(), handles.end());
+                for (size_t i = 0; i < n; i++) {
+                    queue.UpdatePriority(handles[i], values[(i * 7919) % n]);
+                }
+            } else {
+                queue.InsertRange(values.begin(), values.end());
+            }
+
+            long long nextSum = 0;
+            double nextMs = MeasureMs([&]() {
+                for (size_t r = 0; r < repeats; r++) {
+                    for (PriorityQueue::Element_t *node = queue.GetHead(); node != NULL; node = node->pNext) {
+                        nextSum += node->value;
+                    }
+                }
+            });
+
+            long long iterSum = 0;
+            double iterMs = MeasureMs([&]() {
+                for (size_t r = 0; r < repeats; r++) {
+                    for (PriorityQueue::const_iterator it = queue.begin(); it != queue.end(); ++it) {
+                        iterSum += it->value;
+                    }
+                }
+            });
+
+            long long valuesSum = 0;
+            double valuesMs = MeasureMs([&]() {
+                for (size_t r = 0; r < repeats; r++) {
+                    for (const int &value : queue.Values()) {
+                        valuesSum += value;
+                    }
+                }
+            });
+
+            EXPECT_EQ(nextSum, iterSum);
+            EXPECT_EQ(nextSum, valuesSum);
+            if (churned) {
+                printf("%10zu %8s %16s %16.2f %16.2f %16.2f\n", n, "churned", "-", nextMs * 1e6 / total,
+                       iterMs * 1e6 / total, valuesMs * 1e6 / total);
+            } else {
+                EXPECT_EQ(listSum, nextSum);
+                printf("%10zu %8s %16.2f %16.2f %16.2f %16.2f\n", n, "bulk", listMs * 1e6 / total,
+                       nextMs * 1e6 / total, iterMs * 1e6 / total, valuesMs * 1e6 / total);
+            }
+        }
+    }
+}
+
+/*** Konec souboru tdd_benchmarks.cpp ***/
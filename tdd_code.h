@@ -18,27 +18,148 @@
 #ifndef TDD_CODE_H_
 #define TDD_CODE_H_
 
+#include <stddef.h>
+
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The NoPayload struct
+ * Prazdna data polozky, pouzivaji se pokud fronta nese jen hodnoty.
+ */
+struct NoPayload {
+};
+
+/**
+ * @brief The NoValueIndex struct
+ * Pouziva se misto hashovaci funkce, pokud fronta nema mit hashovaci index
+ * (SetValueIndex). Je vychozi pro hodnoty, pro ktere neexistuje std::hash.
+ */
+struct NoValueIndex {
+};
+
+/**
+ * @brief The DefaultValueHash struct
+ * Vychozi hashovaci funkce fronty: std::hash<Key>, pokud existuje, jinak
+ * NoValueIndex.
+ */
+template <typename Key>
+struct DefaultValueHash {
+    typedef typename std::conditional<std::is_default_constructible<std::hash<Key> >::value,
+                                      std::hash<Key>, NoValueIndex>::type type;
+};
+
+/**
+ * @brief The ValueIndex class
+ * Hashovaci index hodnota -> polozka (tenka obalka nad std::unordered_map).
+ */
+template <typename Key, typename Value, typename Hash>
+class ValueIndex
+{
+public:
+    /// Vrati polozku pro hodnotu "key", nebo NULL.
+    Value Find(const Key &key) const {
+        typename std::unordered_map<Key, Value, Hash>::const_iterator it = m_map.find(key);
+        return (it != m_map.end()) ? it->second : Value();
+    }
+    /// Nastavi polozku pro hodnotu "key".
+    void Set(const Key &key, Value value) { m_map[key] = value; }
+    /// Prida zaznam pro "key", pokud tam jeste neni (jedno hledani). Vrati true, pokud ho pridal.
+    bool Add(const Key &key, Value value) { return m_map.insert(std::make_pair(key, value)).second; }
+    /// Odstrani zaznam hodnoty "key".
+    void Erase(const Key &key) { m_map.erase(key); }
+    /// Odstrani vsechny zaznamy.
+    void Clear() { m_map.clear(); }
+    /// Vrati pocet zaznamu.
+    size_t Size() const { return m_map.size(); }
+
+private:
+    std::unordered_map<Key, Value, Hash> m_map;     ///< Zaznamy indexu.
+};
+
+/**
+ * @brief The ValueIndex class
+ * Fronta bez hashovaciho indexu - nic neuklada, hodnota nemusi mit std::hash.
+ */
+template <typename Key, typename Value>
+class ValueIndex<Key, Value, NoValueIndex>
+{
+public:
+    Value Find(const Key &) const { return Value(); }
+    void Set(const Key &, Value) {}
+    bool Add(const Key &, Value) { return false; }
+    void Erase(const Key &) {}
+    void Clear() {}
+    size_t Size() const { return 0; }
+};
+
 /**
  * @brief The PriorityQueue class
  * Prioritni fronta (polozky vzdy serazeny od max po min) implementovana pomoci
  * tzv. linked listu (kazda polozka ma odkaz na  nasledujici polozku).
- * Dale ma kazda polozka hodnotu typu "int", pricemz fronta muze obsahovat vice
+ * Dale ma kazda polozka hodnotu typu "Key", pricemz fronta muze obsahovat vice
  * polozek se stejnou hodnotou.
+ * Vedle listu je udrzovan index serazeny od min po max (stejne hodnoty podle
+ * adresy polozky), rozdeleny na useky
+ * (souvisla pole nejvyse INDEX_CHUNK_SIZE zaznamu, jako listy B+ stromu)
+ * pod jednim polem useku. Misto pro novou polozku se hleda binarnim
+ * vyhledavanim v poli useku a pak v useku, sousede v indexu jsou zaroven
+ * sousedy v listu. Vlozeni/odstraneni zaznamu posouva jen zaznamy v jednom
+ * useku, takze Insert a Remove maji slozitost O(log n + INDEX_CHUNK_SIZE).
+ * Pole useku se posouva jen pri rozdeleni/slouceni useku (nejvyse jednou za
+ * INDEX_CHUNK_SIZE / 4 operaci v useku). Index je rychlejsi nez pruchod listem
+ * od priblizne 64 polozek, u mensich front prevazi alokace prvniho bloku
+ * polozek (viz tdd_benchmarks.cpp).
+ * Polozky se nealokuji jednotlive, ale berou se z bloku (zarovnanych na
+ * cache line) vlastnenych frontou. Odstranene polozky se vraci do seznamu
+ * volnych polozek a pri zruseni fronty se uvolni cele bloky.
+ * Fronta je sablona: "Key" je typ hodnoty, "Payload" data nesena s kazdou
+ * polozkou (ulozena primo v polozce) a "Compare" porovnani hodnot (fronta je
+ * serazena od nejvetsi hodnoty podle "Compare"). Data mohou byt i typu, ktery
+ * lze pouze presouvat. Data, ktera lze kopirovat po bytech
+ * (std::is_trivially_copyable), se do polozky kopiruji pomoci memcpy.
+ * "Hash" je hashovaci funkce pro SetValueIndex (hodnoty musi mit i operator==).
+ * Pro hodnoty bez std::hash je vychozi NoValueIndex, fronta pak funguje bez
+ * hashovaciho indexu a SetValueIndex(true) nelze prelozit.
+ * Pokud Insert, InsertRange nebo UpdatePriority selze vyjimkou (napr.
+ * std::bad_alloc nebo vyjimka z kopirovani hodnoty), fronta zustane beze
+ * zmeny a data vkladane polozky zustanou volajicimu. Predpoklada se, ze
+ * presun hodnoty a dat vyjimku nevyhazuje.
+ * Puvodni fronta hodnot typu "int" je dostupna jako PriorityQueue.
  */
-class PriorityQueue
+template <typename Key, typename Payload = NoPayload, typename Compare = std::less<Key>,
+          typename Hash = typename DefaultValueHash<Key>::type>
+class BasicPriorityQueue
 {
 public:
     /**
-     * @brief PriorityQueue
+     * @brief BasicPriorityQueue
      * Konstruktor, vytvori prazdnou frontu.
      */
-    PriorityQueue();
+    BasicPriorityQueue();
+
+    /**
+     * @brief BasicPriorityQueue
+     * Konstruktor, vytvori frontu obsahujici vsechny hodnoty z "values".
+     * Hodnoty se seradi jednou a polozky se propoji jednim pruchodem.
+     * @param values Pocatecni hodnoty fronty.
+     */
+    explicit BasicPriorityQueue(const std::vector<Key> &values);
 
     /**
-     * @brief ~PriorityQueue
+     * @brief ~BasicPriorityQueue
      * Destruktor, odstrani vsechny polozky i frontu samotnou.
      */
-    ~PriorityQueue();
+    ~BasicPriorityQueue();
+
+    /**
+     * Fronta vlastni sve bloky polozek, kopirovat ji nelze.
+     */
+    BasicPriorityQueue(const BasicPriorityQueue &) = delete;
+    BasicPriorityQueue &operator=(const BasicPriorityQueue &) = delete;
 
     /**
      * @brief The Element_t struct
@@ -47,27 +168,179 @@ public:
     struct Element_t {
         Element_t *pNext;   ///< Ukazatel na nasledujici prvek ve fronte.
 
-        int value;          ///< Hodnota teto polozky ve fronte.
+        Key value;          ///< Hodnota teto polozky ve fronte.
+
+        Payload payload;    ///< Data nesena polozkou.
     };
 
     /**
      * @brief Insert
      * Zaradi novou polozku s hodnotou "value" do fronty na patricne misto (tak
      * aby bylo zachovano poradi max->min). Pokud polozka s danou hodnotou jiz
-     * existuji zaradi novou polozku pred/za jiz existujici.
+     * existuji zaradi novou polozku pred/za jiz existujici (polozky se stejnou
+     * hodnotou jsou v indexu serazeny podle adresy).
+     * Slozitost je O(log n + INDEX_CHUNK_SIZE).
+     * @param value Hodnota nove polozky.
+     * @return Vrati ukazatel na novou polozku. Polozka se v pameti nepresouva,
+     * ukazatel je platny (lze ho pouzit v UpdatePriority/Erase), dokud neni
+     * polozka odstranena.
+     */
+    Element_t *Insert(const Key &value);
+
+    /**
+     * @brief Insert
+     * Zaradi novou polozku s hodnotou "value" a daty "payload" do fronty.
+     * Data se do polozky presunou.
+     * @param value Hodnota nove polozky.
+     * @param payload Data nove polozky.
+     * @return Vrati ukazatel na novou polozku (viz Insert(value)).
+     */
+    Element_t *Insert(const Key &value, Payload &&payload);
+
+    /**
+     * @brief Insert
+     * Zaradi novou polozku s hodnotou "value" a kopii dat "payload" do fronty.
      * @param value Hodnota nove polozky.
+     * @param payload Data nove polozky.
+     * @return Vrati ukazatel na novou polozku (viz Insert(value)).
      */
-    void Insert(int value);
+    Element_t *Insert(const Key &value, const Payload &payload);
+
+    /**
+     * @brief InsertRange
+     * Zaradi do fronty vsechny hodnoty z rozsahu [first, last). Hodnoty se
+     * seradi a slouci s obsahem fronty najednou (O(n + k log k)), misto
+     * hledani mista pro kazdou hodnotu zvlast.
+     * @param first Iterator na prvni vkladanou hodnotu.
+     * @param last Iterator za posledni vkladanou hodnotu.
+     */
+    template <typename InputIterator>
+    void InsertRange(InputIterator first, InputIterator last)
+    {
+        std::vector<Key> values(first, last);
+        InsertBatch(values);
+    }
 
     /**
      * @brief Remove
      * Odstrani polozku s hodnotou "value" z fronty a vrati "true", pokud polozka
      * neni nalezena vrati "false". Pokud se ve fronte nachazi vice polozek se
      * stejnou hodnotou "value", pak odstrani libovolnou z nich.
+     * Slozitost je O(log n + INDEX_CHUNK_SIZE).
      * @param value Hodnota polozky, ktera ma byt odstranena.
      * @return Vrati true, pokud byla polozka nalezena a odstranena, jinak vraci false.
      */
-    bool Remove(int value);
+    bool Remove(const Key &value);
+
+    /**
+     * @brief Erase
+     * Odstrani z fronty polozku "handle" (vracenou z Insert nebo Find).
+     * Polozka se v indexu najde binarnim vyhledavanim podle hodnoty a adresy,
+     * pak se posunou zaznamy useku za ni. Slozitost je
+     * O(log n + INDEX_CHUNK_SIZE) - list se neprochazi.
+     * @param handle Polozka, ktera je ve fronte (jinak je chovani
+     * nedefinovane, v ladicim prekladu selze assert).
+     */
+    void Erase(Element_t *handle);
+
+    /**
+     * @brief UpdatePriority
+     * Zmeni hodnotu polozky "handle" na "newValue" a presune ji na patricne
+     * misto ve fronte. Polozka ani jeji data se nerealokuji a ukazatel zustava
+     * platny. Polozka se najde jako v Erase, odstrani se ze sveho useku
+     * a vlozi do useku nove hodnoty. Slozitost je O(log n + INDEX_CHUNK_SIZE).
+     * @param handle Polozka, ktera je ve fronte (jinak je chovani
+     * nedefinovane, v ladicim prekladu selze assert).
+     * @param newValue Nova hodnota polozky.
+     */
+    void UpdatePriority(Element_t *handle, const Key &newValue);
+
+    /**
+     * @brief PopMax
+     * Odstrani z fronty prvni (nejvetsi) polozku a vrati jeji hodnotu.
+     * @param value Sem se ulozi hodnota odstranene polozky.
+     * @return Vrati false, pokud je fronta prazdna, jinak vraci true.
+     */
+    bool PopMax(Key &value);
+
+    /**
+     * @brief PopMax
+     * Odstrani z fronty prvni (nejvetsi) polozku a vrati jeji hodnotu a data
+     * (data se z polozky presunou).
+     * @param value Sem se ulozi hodnota odstranene polozky.
+     * @param payload Sem se presunou data odstranene polozky.
+     * @return Vrati false, pokud je fronta prazdna, jinak vraci true.
+     */
+    bool PopMax(Key &value, Payload &payload);
+
+    /**
+     * @brief PopTopK
+     * Odstrani z fronty az "k" prvnich (nejvetsich) polozek najednou a jejich
+     * hodnoty zapise do "out" (od nejvetsi). Nic se nealokuje, pouze se
+     * zkrati index a polozky se vrati do seznamu volnych polozek.
+     * Data odstranenych polozek se zrusi, pro jejich ziskani slouzi
+     * PopTopK(k, out, payloads).
+     * @param k Maximalni pocet odstranenych polozek.
+     * @param out Pole pro alespon "k" hodnot.
+     * @return Vrati pocet odstranenych polozek (mensi nez "k", pokud je fronta kratsi).
+     */
+    size_t PopTopK(size_t k, Key *out);
+
+    /**
+     * @brief PopTopK
+     * Jako PopTopK(k, out), navic data odstranenych polozek presune do
+     * "payloads" (ve stejnem poradi jako hodnoty v "out").
+     * @param k Maximalni pocet odstranenych polozek.
+     * @param out Pole pro alespon "k" hodnot.
+     * @param payloads Pole pro alespon "k" dat.
+     * @return Vrati pocet odstranenych polozek (mensi nez "k", pokud je fronta kratsi).
+     */
+    size_t PopTopK(size_t k, Key *out, Payload *payloads);
+
+    /**
+     * @brief DrainTo
+     * Odstrani z fronty vsechny polozky a jejich hodnoty prida (od nejvetsi)
+     * na konec "container" pomoci push_back. Data polozek se zrusi, pro jejich
+     * ziskani slouzi DrainTo(container, payloads).
+     * @param container Kontejner, do ktereho se hodnoty pridaji.
+     * @return Vrati pocet odstranenych polozek.
+     */
+    template <typename Container>
+    size_t DrainTo(Container &container)
+    {
+        size_t count = m_length;
+        for (size_t c = m_chunks.size(); c > 0; c--) {
+            const Chunk_t &chunk = m_chunks[c - 1];
+            for (size_t i = chunk.size(); i > 0; i--) {
+                container.push_back(chunk[i - 1].value);
+            }
+        }
+        DropTop(count);
+        return count;
+    }
+
+    /**
+     * @brief DrainTo
+     * Jako DrainTo(container), navic data polozek presune (ve stejnem poradi)
+     * na konec "payloads" pomoci push_back.
+     * @param container Kontejner, do ktereho se hodnoty pridaji.
+     * @param payloads Kontejner, do ktereho se data presunou.
+     * @return Vrati pocet odstranenych polozek.
+     */
+    template <typename Container, typename PayloadContainer>
+    size_t DrainTo(Container &container, PayloadContainer &payloads)
+    {
+        size_t count = m_length;
+        for (size_t c = m_chunks.size(); c > 0; c--) {
+            const Chunk_t &chunk = m_chunks[c - 1];
+            for (size_t i = chunk.size(); i > 0; i--) {
+                container.push_back(chunk[i - 1].value);
+                payloads.push_back(std::move(chunk[i - 1].pElement->payload));
+            }
+        }
+        DropTop(count);
+        return count;
+    }
 
     /**
      * @brief Find
@@ -76,15 +349,50 @@ public:
      * @param value Hodnota hledane polozky.
      * @return Vrati ukazatel na polozku s hodnotou "value", nebo NULL pokud takova neexistuje.
      */
-    Element_t *Find(int value);
+    Element_t *Find(const Key &value);
 
     /**
      * @brief Length
      * Vraci delku fronty. Delka prazdne fronty je 0
+     * Delka se neprepocitava, fronta si udrzuje pocet polozek (slozitost O(1)).
+     * Shodu s delkou listu overuje IsConsistent().
      * @return Vrati delku fronty.
      */
     size_t Length();
 
+    /**
+     * @brief SetValueIndex
+     * Zapne/vypne hashovaci index hodnota -> polozka (pouziva "Hash"
+     * a operator==, ktere musi odpovidat "Compare"). Se zapnutym indexem ma
+     * Find ocekavanou slozitost O(1) a Remove bere polozku primo z indexu
+     * (jeji zaznam v indexu useku se ale stale hleda binarne, O(log n)).
+     * Remove tim nezrychli: udrzba indexu pri kazdem Insert/Remove stoji
+     * vic, nez usetri, v CancelHeavy (tdd_benchmarks.cpp) je fronta se
+     * zapnutym indexem o 10 az 100 % pomalejsi pri 64 az 262144 polozkach.
+     * Vyplati se jen pro caste Find hodnot, ktere ve fronte nejsou.
+     * Index drzi jeden zaznam pro kazdou ruznou hodnotu ve fronte
+     * (ukazuje na jednu z polozek s touto hodnotou), coz je pro "int"
+     * priblizne 40 B na ruznou hodnotu (uzel unordered_map + ukazatel v tabulce
+     * bucketu).
+     * Ve vychozim stavu je index vypnuty.
+     * @param enabled true pro zapnuti indexu, false pro vypnuti.
+     */
+    void SetValueIndex(bool enabled);
+
+    /**
+     * @brief IsConsistent
+     * Ladici kontrola: projde cely list (O(n)) a overi, ze odpovida indexu
+     * (stejny pocet polozek jako vraci Length(), stejne poradi a hodnoty)
+     * a pripadne i hashovacimu indexu. Pokud je pri prekladu definovano
+     * PRIORITY_QUEUE_CHECK_CONSISTENCY (pro cely preklad vcetne
+     * tdd_code.cpp, ktery obsahuje PriorityQueue, a bez NDEBUG), vola ji assert po
+     * kazde zmene fronty (Insert, InsertRange, Remove, Erase, UpdatePriority,
+     * PopMax, PopTopK, DrainTo), kazda zmena pak ma slozitost O(n). Bez
+     * makra ji zadna metoda fronty sama nevola.
+     * @return Vrati true, pokud list a indexy odpovidaji, jinak vraci false.
+     */
+    bool IsConsistent() const;
+
     /**
      * @brief GetHead
      * Vraci ukazatel na prvni polozku ve fronte, ktera je vzdy zaroven polozkou
@@ -95,7 +403,453 @@ public:
     Element_t *GetHead();
 
 protected:
-    Element_t *m_pHead;     ///< Ukazatel na zacatek fronty.
+    struct Index_t;
+
+    /// Usek indexu - souvisle pole zaznamu serazene od min po max.
+    typedef std::vector<Index_t> Chunk_t;
+
+    /**
+     * @brief The Cursor_t struct
+     * Pozice iteratoru v indexu, posouva se po useku od konce (max->min).
+     */
+    struct Cursor_t {
+        const Chunk_t *pChunk;      ///< Usek s aktualnim zaznamem.
+        const Chunk_t *pFirst;      ///< Prvni usek indexu (konec iterace).
+        size_t offset;              ///< Pozice za aktualnim zaznamem v useku.
+
+        Cursor_t(const Chunk_t *chunk = NULL, const Chunk_t *first = NULL, size_t off = 0)
+            : pChunk(chunk), pFirst(first), offset(off) {}
+
+        /// Vrati aktualni zaznam.
+        const Index_t &Entry() const { return (*pChunk)[offset - 1]; }
+
+        //moving to smaller entry - from start of chunk to end of previous one
+        void Increment() {
+            if (offset > 1 || pChunk == pFirst) {
+                offset--;
+            } else {
+                pChunk--;
+                offset = pChunk->size();
+            }
+        }
+
+        //moving to bigger entry - from end of chunk to start of next one
+        void Decrement() {
+            if (offset < pChunk->size()) {
+                offset++;
+            } else {
+                pChunk++;
+                offset = 1;
+            }
+        }
+
+        bool operator==(const Cursor_t &other) const {
+            return pChunk == other.pChunk && offset == other.offset;
+        }
+    };
+
+public:
+    /**
+     * @brief The BasicIterator class
+     * Iterator pres polozky fronty v poradi max->min. Neprochazi list pres
+     * pNext, ale useky indexu (od konce). Postupne se ctou jen zaznamy indexu,
+     * kazde *it/it-> cte polozku v bloku polozek. Po promichani fronty
+     * (Erase, UpdatePriority, Insert do zaplnene fronty) lezi sousedni
+     * polozky v blocich na nahodnych mistech a pruchod je pak zhruba stejne
+     * pomaly jako pres pNext (viz FullScan v tdd_benchmarks.cpp). Pro pruchod
+     * jen hodnotami slouzi Values(), ktere cte pouze index.
+     * "ElementT" je Element_t (iterator) nebo const Element_t (const_iterator).
+     * Hodnota polozky se pres iterator menit nesmi (index drzi jeji kopii),
+     * ke zmene slouzi UpdatePriority. Pres const_iterator nelze menit nic.
+     * Po Insert/Remove/Erase/UpdatePriority/Pop* je iterator neplatny.
+     */
+    template <typename ElementT>
+    class BasicIterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef Element_t value_type;
+        typedef ptrdiff_t difference_type;
+        typedef ElementT *pointer;
+        typedef ElementT &reference;
+
+        BasicIterator() {}
+        BasicIterator(const Chunk_t *pChunk, const Chunk_t *pFirst, size_t offset)
+            : m_cursor(pChunk, pFirst, offset) {}
+
+        //iterator -> const_iterator
+        BasicIterator(const BasicIterator<Element_t> &other) : m_cursor(other.m_cursor) {}
+
+        reference operator*() const { return *m_cursor.Entry().pElement; }
+        pointer operator->() const { return m_cursor.Entry().pElement; }
+
+        BasicIterator &operator++() { m_cursor.Increment(); return *this; }
+        BasicIterator operator++(int) { BasicIterator tmp(*this); m_cursor.Increment(); return tmp; }
+        BasicIterator &operator--() { m_cursor.Decrement(); return *this; }
+        BasicIterator operator--(int) { BasicIterator tmp(*this); m_cursor.Decrement(); return tmp; }
+
+        bool operator==(const BasicIterator &other) const { return m_cursor == other.m_cursor; }
+        bool operator!=(const BasicIterator &other) const { return !(*this == other); }
+
+    private:
+        template <typename OtherElementT>
+        friend class BasicIterator;
+
+        Cursor_t m_cursor;          ///< Pozice v indexu.
+    };
+
+    /**
+     * @brief The ValueIterator class
+     * Iterator pres hodnoty fronty v poradi max->min. Cte jen kopie hodnot
+     * v indexu (souvisla pole useku), polozky v blocich nenavstevuje.
+     * Po Insert/Remove/Erase/UpdatePriority/Pop* je iterator neplatny.
+     */
+    class ValueIterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef Key value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Key *pointer;
+        typedef const Key &reference;
+
+        ValueIterator() {}
+        ValueIterator(const Chunk_t *pChunk, const Chunk_t *pFirst, size_t offset)
+            : m_cursor(pChunk, pFirst, offset) {}
+
+        reference operator*() const { return m_cursor.Entry().value; }
+        pointer operator->() const { return &m_cursor.Entry().value; }
+
+        ValueIterator &operator++() { m_cursor.Increment(); return *this; }
+        ValueIterator operator++(int) { ValueIterator tmp(*this); m_cursor.Increment(); return tmp; }
+        ValueIterator &operator--() { m_cursor.Decrement(); return *this; }
+        ValueIterator operator--(int) { ValueIterator tmp(*this); m_cursor.Decrement(); return tmp; }
+
+        bool operator==(const ValueIterator &other) const { return m_cursor == other.m_cursor; }
+        bool operator!=(const ValueIterator &other) const { return !(*this == other); }
+
+    private:
+        Cursor_t m_cursor;          ///< Pozice v indexu.
+    };
+
+    /**
+     * @brief The ValueRange class
+     * Rozsah hodnot fronty (max->min) pro range-based for, vraci Values().
+     */
+    class ValueRange
+    {
+    public:
+        ValueRange(ValueIterator first, ValueIterator last) : m_first(first), m_last(last) {}
+
+        ValueIterator begin() const { return m_first; }
+        ValueIterator end() const { return m_last; }
+
+    private:
+        ValueIterator m_first;      ///< Prvni (nejvetsi) hodnota.
+        ValueIterator m_last;       ///< Za posledni (nejmensi) hodnotou.
+    };
+
+    typedef BasicIterator<Element_t> iterator;
+    typedef BasicIterator<const Element_t> const_iterator;
+
+    /**
+     * @brief begin
+     * @return Vrati iterator na prvni (nejvetsi) polozku fronty.
+     */
+    iterator begin() { return BeginAs<iterator>(); }
+    const_iterator begin() const { return BeginAs<const_iterator>(); }
+
+    /**
+     * @brief end
+     * @return Vrati iterator za posledni (nejmensi) polozku fronty.
+     */
+    iterator end() { return EndAs<iterator>(); }
+    const_iterator end() const { return EndAs<const_iterator>(); }
+
+    /**
+     * @brief Values
+     * @return Vrati rozsah hodnot fronty od nejvetsi po nejmensi (cte jen
+     * index, viz ValueIterator).
+     */
+    ValueRange Values() const { return ValueRange(BeginAs<ValueIterator>(), EndAs<ValueIterator>()); }
+
+protected:
+    /**
+     * @brief The Index_t struct
+     * Polozka indexu, drzi kopii hodnoty (aby se pri vyhledavani nemuselo
+     * pristupovat k polozkam listu) a ukazatel na odpovidajici polozku listu.
+     */
+    struct Index_t {
+        Key value;              ///< Hodnota polozky.
+
+        Element_t *pElement;    ///< Ukazatel na polozku ve fronte.
+    };
+
+    /**
+     * @brief The Position_t struct
+     * Pozice zaznamu v indexu. Pozice za nejvetsim zaznamem ma "chunk" rovno
+     * poctu useku.
+     */
+    struct Position_t {
+        size_t chunk;           ///< Poradi useku.
+
+        size_t offset;          ///< Poradi zaznamu v useku.
+    };
+
+    /// Vrati iterator na prvni polozku (pro iterator i const_iterator).
+    template <typename Iterator>
+    Iterator BeginAs() const {
+        if (m_chunks.empty()) {
+            return Iterator();
+        }
+        return Iterator(&m_chunks.back(), &m_chunks.front(), m_chunks.back().size());
+    }
+
+    /// Vrati iterator za posledni polozku (pro iterator i const_iterator).
+    template <typename Iterator>
+    Iterator EndAs() const {
+        if (m_chunks.empty()) {
+            return Iterator();
+        }
+        return Iterator(&m_chunks.front(), &m_chunks.front(), 0);
+    }
+
+    /**
+     * @brief LowerBound
+     * Vrati pozici prvni polozky indexu s hodnotou vetsi nebo rovnou "value".
+     * @param value Hledana hodnota.
+     * @return Pozice v indexu (za nejvetsim zaznamem, pokud takova polozka
+     * neexistuje).
+     */
+    Position_t LowerBound(const Key &value) const;
+
+    /**
+     * @brief SlotOf
+     * Vrati pozici, na kterou v indexu patri polozka "node" s hodnotou "value"
+     * (podle hodnoty a adresy polozky, viz EntryLess).
+     * @param value Hodnota polozky.
+     * @param node Polozka.
+     * @return Pozice v indexu (za nejvetsim zaznamem, pokud jsou vsechny mensi).
+     */
+    Position_t SlotOf(const Key &value, const Element_t *node) const;
+
+    /**
+     * @brief PositionOf
+     * Vrati pozici polozky "handle" v indexu (binarnim vyhledavanim, viz SlotOf).
+     * @param handle Polozka, ktera je ve fronte.
+     * @return Pozice v indexu.
+     */
+    Position_t PositionOf(Element_t *handle) const;
+
+    /// Vrati zaznam indexu na pozici "pos".
+    const Index_t &Entry(const Position_t &pos) const { return m_chunks[pos.chunk][pos.offset]; }
+
+    /// Vrati zaznam pred pozici "pos" (mensi hodnota), nebo NULL.
+    const Index_t *Below(const Position_t &pos) const;
+
+    /// Vrati zaznam za pozici "pos" (vetsi nebo stejna hodnota), nebo NULL.
+    const Index_t *Above(const Position_t &pos) const;
+
+    /**
+     * @brief ReserveEntry
+     * Najde pozici pro zaznam polozky "node" s hodnotou "value" a zajisti pro
+     * nej misto v useku (plny usek rozdeli na dve poloviny). Pokud dojde
+     * pamet, index zustane beze zmeny.
+     * @param value Hodnota polozky.
+     * @param node Polozka.
+     * @return Vrati pozici pro PlaceEntry (plati do dalsi zmeny indexu).
+     */
+    Position_t ReserveEntry(const Key &value, const Element_t *node);
+
+    /**
+     * @brief PlaceEntry
+     * Presune "entry" na pozici "pos" vracenou z ReserveEntry. Nic nealokuje.
+     * @param pos Pozice v indexu.
+     * @param entry Vkladany zaznam.
+     */
+    void PlaceEntry(const Position_t &pos, Index_t &entry);
+
+    /**
+     * @brief EraseEntry
+     * Odstrani zaznam na pozici "pos" z indexu. Prilis maly usek se slouci se
+     * sousednim usekem, nebo si s nim zaznamy rozdeli. Nic nealokuje (kazdy
+     * usek ma kapacitu INDEX_CHUNK_SIZE).
+     * @param pos Pozice v indexu.
+     */
+    void EraseEntry(const Position_t &pos);
+
+    /**
+     * @brief Rebalance
+     * Udrzuje useky alespon z INDEX_CHUNK_SIZE / 4 plne (krome jedineho
+     * useku) a odstrani prazdny usek.
+     * @param chunk Poradi useku, ze ktereho byl odstranen zaznam.
+     */
+    void Rebalance(size_t chunk);
+
+    /**
+     * @brief Link
+     * Propoji polozku na pozici "pos" indexu s jejimi sousedy v listu.
+     * @param pos Pozice v indexu.
+     */
+    void Link(const Position_t &pos);
+
+    /**
+     * @brief Unlink
+     * Vypoji polozku na pozici "pos" indexu z listu a z hashovaciho indexu,
+     * zaznam v indexu zustava.
+     * @param pos Pozice v indexu.
+     */
+    void Unlink(const Position_t &pos);
+
+    /**
+     * @brief RemoveAt
+     * Odstrani polozku na pozici "pos" indexu z fronty.
+     * @param pos Pozice v indexu.
+     */
+    void RemoveAt(const Position_t &pos);
+
+    /**
+     * @brief DropTop
+     * Odstrani z fronty "count" prvnich polozek (konec posledniho useku,
+     * pripadne cele useky) najednou.
+     * @param count Pocet odstranenych polozek (nejvyse delka fronty).
+     */
+    void DropTop(size_t count);
+
+    /**
+     * @brief InsertBatch
+     * Vytvori polozky pro "values", seradi je, slouci je s indexem do novych
+     * useku (zaplnenych z poloviny) a znovu propoji cely list. Novy index se
+     * stavi vedle stavajiciho, pri vyjimce se polozky zrusi a fronta se nezmeni.
+     * @param values Vkladane hodnoty.
+     */
+    void InsertBatch(const std::vector<Key> &values);
+
+    /**
+     * @brief AppendEntry
+     * Prida "entry" na konec indexu "chunks", ktery se stavi v InsertBatch
+     * (useky se plni do poloviny).
+     * @param chunks Stavene useky.
+     * @param entry Pridavany zaznam.
+     */
+    void AppendEntry(std::vector<Chunk_t> &chunks, const Index_t &entry);
+
+    /**
+     * @brief RebuildValueIndex
+     * Nastavi v hashovacim indexu zaznam pro kazdou hodnotu ve fronte.
+     */
+    void RebuildValueIndex();
+
+    /**
+     * @brief CheckConsistency
+     * Po zmene fronty overi IsConsistent() pomoci assert, jen pokud je
+     * definovano PRIORITY_QUEUE_CHECK_CONSISTENCY, jinak nedela nic.
+     */
+    void CheckConsistency() const;
+
+    /**
+     * @brief AllocElement
+     * Vrati polozku ze seznamu volnych polozek. Pokud je seznam prazdny,
+     * alokuje novy blok a rozdeli ho na ELEMENTS_PER_BLOCK polozek.
+     * @return Ukazatel na neinicializovanou polozku.
+     */
+    Element_t *AllocElement();
+
+    /**
+     * @brief FreeElement
+     * Zrusi hodnotu a data polozky "element" a vrati ji do seznamu volnych
+     * polozek.
+     * @param element Polozka, ktera uz neni ve fronte.
+     */
+    void FreeElement(Element_t *element);
+
+    /**
+     * @brief ReleaseElement
+     * Vrati polozku "element", jejiz hodnota a data nejsou vytvoreny, do
+     * seznamu volnych polozek.
+     * @param element Polozka z AllocElement.
+     */
+    void ReleaseElement(Element_t *element);
+
+    /**
+     * @brief ConstructElement
+     * Vytvori v polozce "node" hodnotu "value" a presune do ni "payload".
+     * Pokud se to nepodari, polozka zustane bez hodnoty i dat.
+     * @param node Polozka z AllocElement.
+     * @param value Hodnota polozky.
+     * @param payload Data polozky.
+     */
+    void ConstructElement(Element_t *node, const Key &value, Payload &payload);
+
+    /**
+     * @brief EntryLess
+     * Poradi zaznamu v indexu: podle hodnoty, zaznamy se stejnou hodnotou
+     * podle adresy polozky.
+     * @return Vrati true, pokud ma byt "entry" v indexu pred zaznamem polozky
+     * "node" s hodnotou "value".
+     */
+    bool EntryLess(const Index_t &entry, const Key &value, const Element_t *node) const;
+
+    /**
+     * @brief Equal
+     * Porovna hodnoty "a" a "b" pomoci "Compare".
+     * @return Vrati true, pokud ani jedna hodnota neni mensi nez druha.
+     */
+    bool Equal(const Key &a, const Key &b) const;
+
+    /**
+     * @brief ConstructPayload
+     * Presune "payload" do polozky "node", jejiz data jeste nejsou
+     * inicializovana. Data, ktera lze kopirovat po bytech, se kopiruji pomoci
+     * memcpy.
+     */
+    static void ConstructPayload(Element_t *node, Payload &payload, std::true_type);
+    static void ConstructPayload(Element_t *node, Payload &payload, std::false_type);
+
+    /**
+     * @brief DestroyElement
+     * Zrusi hodnotu a data polozky "node" (pokud maji trivialni destruktor,
+     * nedela nic).
+     */
+    static void DestroyElement(Element_t *node, std::true_type);
+    static void DestroyElement(Element_t *node, std::false_type);
+
+    /// Lze data kopirovat po bytech?
+    typedef std::integral_constant<bool, std::is_trivially_copyable<Payload>::value> PayloadIsTrivial;
+    /// Maji hodnota i data trivialni destruktor (bloky lze uvolnit bez pruchodu polozkami)?
+    typedef std::integral_constant<bool, std::is_trivially_destructible<Key>::value &&
+        std::is_trivially_destructible<Payload>::value> ElementIsTriviallyDestructible;
+
+    static const size_t CACHE_LINE_SIZE = 64;       ///< Zarovnani bloku polozek.
+    static const size_t ELEMENTS_PER_BLOCK = 512;   ///< Pocet polozek v jednom bloku.
+    static const size_t INDEX_CHUNK_SIZE = 256;     ///< Nejvetsi pocet zaznamu v useku indexu.
+
+    Element_t *m_pHead;             ///< Ukazatel na zacatek fronty.
+
+    std::vector<Chunk_t> m_chunks;  ///< Useky indexu od min po max (posledni zaznam je m_pHead).
+    size_t m_length;                ///< Pocet polozek ve fronte.
+
+    Element_t *m_pFreeList;         ///< Seznam volnych polozek (propojeny pres pNext).
+    std::vector<void *> m_blocks;   ///< Alokovane bloky polozek.
+
+    bool m_useValueIndex;                               ///< Je hashovaci index zapnuty?
+    ValueIndex<Key, Element_t *, Hash> m_valueIndex;    ///< Hodnota -> jedna z polozek s touto hodnotou.
+
+    Compare m_compare;              ///< Porovnani hodnot.
 };
 
+/**
+ * @brief PriorityQueue
+ * Prioritni fronta hodnot typu "int" bez dalsich dat.
+ */
+typedef BasicPriorityQueue<int> PriorityQueue;
+
+//definice metod sablony
+#include "tdd_code_impl.h"
+
+//fronta hodnot typu "int" se instancuje v tdd_code.cpp
+extern template class BasicPriorityQueue<int>;
+
+
+
 #endif // TDD_CODE_H_
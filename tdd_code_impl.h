@@ -0,0 +1,868 @@
+//======== Copyright (c) 2021, FIT VUT Brno, All rights reserved. ============//
+//
+// Purpose:     Test Driven Development - priority queue code
+//
+// $NoKeywords: $ivs_project_1 $tdd_code_impl.h
+// $Author:     Martin Kubicka <xkubic45@stud.fit.vutbr.cz>
+// $Date:       $2022-03-09
+//============================================================================//
+/**
+ * @file tdd_code_impl.h
+ * @author Martin Kubicka
+ * 
+ * @brief Implementace metod sablony prioritni fronty (vklada se z tdd_code.h).
+ */
+
+#pragma once
+
+#ifndef TDD_CODE_IMPL_H_
+#define TDD_CODE_IMPL_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "tdd_code.h"
+
+//creating queue and setting head to NULL
+template <typename Key, typename Payload, typename Compare, typename Hash>
+BasicPriorityQueue<Key, Payload, Compare, Hash>::BasicPriorityQueue()
+{
+    m_pHead = NULL;
+    m_pFreeList = NULL;
+    m_length = 0;
+    m_useValueIndex = false;
+}
+
+//creating queue from values
+template <typename Key, typename Payload, typename Compare, typename Hash>
+BasicPriorityQueue<Key, Payload, Compare, Hash>::BasicPriorityQueue(const std::vector<Key> &values)
+{
+    m_pHead = NULL;
+    m_pFreeList = NULL;
+    m_length = 0;
+    m_useValueIndex = false;
+
+    InsertBatch(values);
+}
+
+//deleting queue - nodes live in pool blocks, so whole blocks are released
+template <typename Key, typename Payload, typename Compare, typename Hash>
+BasicPriorityQueue<Key, Payload, Compare, Hash>::~BasicPriorityQueue()
+{
+    //values/payloads with destructor have to be destroyed first
+    if (!ElementIsTriviallyDestructible::value) {
+        for (Element_t *tmp = m_pHead; tmp != NULL; tmp = tmp->pNext) {
+            DestroyElement(tmp, ElementIsTriviallyDestructible());
+        }
+    }
+
+    for (size_t i = 0; i < m_blocks.size(); i++) {
+        free(m_blocks[i]);
+    }
+    m_blocks.clear();
+    m_pFreeList = NULL;
+    m_pHead = NULL;
+}
+
+//inserting values - bigger number will be before smaller number
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Element_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::Insert(const Key &value)
+{
+    return Insert(value, Payload());
+}
+
+//inserting value with payload - everything what can fail (memory for index
+//and value index, copying value) is done before payload is moved into node
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Element_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::Insert(const Key &value, Payload &&payload)
+{
+    //creating new node
+    Element_t *node = AllocElement();
+    try {
+        //nodes with the same value are ordered by address
+        Position_t pos = ReserveEntry(value, node);
+        Index_t entry = { value, node };
+
+        //value index keeps node which is already there
+        bool indexed = m_useValueIndex && m_valueIndex.Add(value, node);
+        try {
+            ConstructElement(node, value, payload);
+        } catch (...) {
+            if (indexed) {
+                m_valueIndex.Erase(value);
+            }
+            throw;
+        }
+
+        PlaceEntry(pos, entry);
+        Link(pos);
+    } catch (...) {
+        //dropping chunk reserved in empty queue
+        if (m_length == 0) {
+            m_chunks.clear();
+        }
+        ReleaseElement(node);
+        throw;
+    }
+    CheckConsistency();
+    return node;
+}
+
+//inserting value with copy of payload
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Element_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::Insert(const Key &value, const Payload &payload)
+{
+    Payload copy(payload);
+    return Insert(value, std::move(copy));
+}
+
+//removing item
+template <typename Key, typename Payload, typename Compare, typename Hash>
+bool BasicPriorityQueue<Key, Payload, Compare, Hash>::Remove(const Key &value)
+{
+    //value index gives node directly, its entry is found by value and address
+    if (m_useValueIndex) {
+        Element_t *node = m_valueIndex.Find(value);
+        if (node == NULL) {
+            return false;
+        }
+        RemoveAt(PositionOf(node));
+        return true;
+    }
+
+    Position_t pos = LowerBound(value);
+    //value wasnt found
+    if (pos.chunk == m_chunks.size() || !Equal(Entry(pos).value, value)) {
+        return false;
+    }
+
+    RemoveAt(pos);
+    return true;
+}
+
+//erasing item by handle
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::Erase(Element_t *handle)
+{
+    RemoveAt(PositionOf(handle));
+}
+
+//changing value of item - entry is moved in index and relinked, node stays;
+//slot for new entry is reserved first, rest cant fail
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::UpdatePriority(Element_t *handle, const Key &newValue)
+{
+    //same value - position in index doesnt change
+    if (Equal(handle->value, newValue)) {
+        Position_t pos = PositionOf(handle);
+        handle->value = newValue;
+        m_chunks[pos.chunk][pos.offset].value = newValue;
+        CheckConsistency();
+        return;
+    }
+
+    Index_t newEntry = { newValue, handle };
+    Position_t newPos = ReserveEntry(newValue, handle);
+    Position_t oldPos = PositionOf(handle);
+    bool indexed = m_useValueIndex && m_valueIndex.Add(newValue, handle);
+    try {
+        handle->value = newValue;
+    } catch (...) {
+        if (indexed) {
+            m_valueIndex.Erase(newValue);
+        }
+        throw;
+    }
+
+    //old entry is unlinked from list, new entry is placed to reserved slot
+    //(entries behind it move), then old entry is erased
+    Unlink(oldPos);
+    PlaceEntry(newPos, newEntry);
+    if (oldPos.chunk == newPos.chunk && oldPos.offset >= newPos.offset) {
+        oldPos.offset++;
+    }
+    EraseEntry(oldPos);
+    Link(SlotOf(newValue, handle));
+    CheckConsistency();
+}
+
+//removing head of queue
+template <typename Key, typename Payload, typename Compare, typename Hash>
+bool BasicPriorityQueue<Key, Payload, Compare, Hash>::PopMax(Key &value)
+{
+    return PopTopK(1, &value) == 1;
+}
+
+//removing head of queue with its payload
+template <typename Key, typename Payload, typename Compare, typename Hash>
+bool BasicPriorityQueue<Key, Payload, Compare, Hash>::PopMax(Key &value, Payload &payload)
+{
+    if (m_pHead == NULL) {
+        return false;
+    }
+    value = m_pHead->value;
+    payload = std::move(m_pHead->payload);
+    DropTop(1);
+    return true;
+}
+
+//removing up to k first items - they are at the end of index
+template <typename Key, typename Payload, typename Compare, typename Hash>
+size_t BasicPriorityQueue<Key, Payload, Compare, Hash>::PopTopK(size_t k, Key *out)
+{
+    size_t count = std::min(k, m_length);
+    size_t i = 0;
+    for (size_t c = m_chunks.size(); i < count; c--) {
+        const Chunk_t &chunk = m_chunks[c - 1];
+        for (size_t j = chunk.size(); j > 0 && i < count; j--, i++) {
+            out[i] = chunk[j - 1].value;
+        }
+    }
+    DropTop(count);
+    return count;
+}
+
+//removing up to k first items with their payloads
+template <typename Key, typename Payload, typename Compare, typename Hash>
+size_t BasicPriorityQueue<Key, Payload, Compare, Hash>::PopTopK(size_t k, Key *out, Payload *payloads)
+{
+    size_t count = std::min(k, m_length);
+    size_t i = 0;
+    for (size_t c = m_chunks.size(); i < count; c--) {
+        const Chunk_t &chunk = m_chunks[c - 1];
+        for (size_t j = chunk.size(); j > 0 && i < count; j--, i++) {
+            out[i] = chunk[j - 1].value;
+            payloads[i] = std::move(chunk[j - 1].pElement->payload);
+        }
+    }
+    DropTop(count);
+    return count;
+}
+
+//finding value
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Element_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::Find(const Key &value)
+{
+    if (m_useValueIndex) {
+        return m_valueIndex.Find(value);
+    }
+
+    Position_t pos = LowerBound(value);
+    //if value was found -> returning pointer to the node with the value
+    if (pos.chunk < m_chunks.size() && Equal(Entry(pos).value, value)) {
+        return Entry(pos).pElement;
+    }
+    //value wasnt found -> returning NULL
+    return NULL;
+}
+
+//turning value index on/off - index stays off, if it cant be built
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::SetValueIndex(bool enabled)
+{
+    static_assert(!std::is_same<Hash, NoValueIndex>::value,
+                  "hashovaci index potrebuje hashovaci funkci (parametr Hash)");
+    m_useValueIndex = false;
+    m_valueIndex.Clear();
+    if (enabled) {
+        try {
+            RebuildValueIndex();
+        } catch (...) {
+            m_valueIndex.Clear();
+            throw;
+        }
+        m_useValueIndex = true;
+    }
+}
+
+//getting lenght - it is counted by insert/remove
+template <typename Key, typename Payload, typename Compare, typename Hash>
+size_t BasicPriorityQueue<Key, Payload, Compare, Hash>::Length()
+{
+    return m_length;
+}
+
+//checking that index and list describe the same queue
+template <typename Key, typename Payload, typename Compare, typename Hash>
+bool BasicPriorityQueue<Key, Payload, Compare, Hash>::IsConsistent() const
+{
+    //chunks arent empty or overfull, index is sorted and matches nodes
+    size_t count = 0;
+    size_t runs = 0;
+    bool runFound = true;
+    const Element_t *runTarget = NULL;
+    const Index_t *prev = NULL;
+    for (size_t c = 0; c < m_chunks.size(); c++) {
+        const Chunk_t &chunk = m_chunks[c];
+        if (chunk.empty() || chunk.size() > INDEX_CHUNK_SIZE) {
+            return false;
+        }
+        for (size_t i = 0; i < chunk.size(); i++) {
+            const Index_t &entry = chunk[i];
+            if ((prev != NULL && !EntryLess(*prev, entry.value, entry.pElement)) ||
+                !Equal(entry.value, entry.pElement->value)) {
+                return false;
+            }
+            //value index has to point to one of nodes in every run of same
+            //values
+            if (m_useValueIndex && (prev == NULL || !Equal(prev->value, entry.value))) {
+                if (!runFound) {
+                    return false;
+                }
+                runTarget = m_valueIndex.Find(entry.value);
+                runFound = false;
+                runs++;
+            }
+            runFound = runFound || entry.pElement == runTarget;
+            prev = &entry;
+            count++;
+        }
+    }
+    if (count != m_length || (m_useValueIndex && (!runFound || runs != m_valueIndex.Size()))) {
+        return false;
+    }
+
+    //list is walked from max, index is stored from min
+    const_iterator it = begin();
+    for (Element_t *tmp = m_pHead; tmp != NULL; tmp = tmp->pNext) {
+        if (it == end() || &*it != tmp) {
+            return false;
+        }
+        ++it;
+    }
+    return it == end();
+}
+
+//binary search for first chunk whose last value isnt smaller than "value",
+//then for first item in the chunk with value >= "value"
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Position_t BasicPriorityQueue<Key, Payload, Compare, Hash>::LowerBound(const Key &value) const
+{
+    const Compare &compare = m_compare;
+    typename std::vector<Chunk_t>::const_iterator chunk = std::lower_bound(
+        m_chunks.begin(), m_chunks.end(), value,
+        [&compare](const Chunk_t &c, const Key &v) { return compare(c.back().value, v); });
+
+    Position_t pos = { (size_t)(chunk - m_chunks.begin()), 0 };
+    if (chunk != m_chunks.end()) {
+        typename Chunk_t::const_iterator entry = std::lower_bound(
+            chunk->begin(), chunk->end(), value,
+            [&compare](const Index_t &e, const Key &v) { return compare(e.value, v); });
+        pos.offset = entry - chunk->begin();
+    }
+    return pos;
+}
+
+//binary search for position of node - entries are ordered by value and then
+//by address of node
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Position_t BasicPriorityQueue<Key, Payload, Compare, Hash>::SlotOf(const Key &value, const Element_t *node) const
+{
+    const BasicPriorityQueue<Key, Payload, Compare, Hash> *queue = this;
+    typename std::vector<Chunk_t>::const_iterator chunk = std::lower_bound(
+        m_chunks.begin(), m_chunks.end(), node,
+        [queue, &value](const Chunk_t &c, const Element_t *n) { return queue->EntryLess(c.back(), value, n); });
+
+    Position_t pos = { (size_t)(chunk - m_chunks.begin()), 0 };
+    if (chunk != m_chunks.end()) {
+        typename Chunk_t::const_iterator found = std::lower_bound(
+            chunk->begin(), chunk->end(), node,
+            [queue, &value](const Index_t &e, const Element_t *n) { return queue->EntryLess(e, value, n); });
+        pos.offset = found - chunk->begin();
+    }
+    return pos;
+}
+
+//entry with the nearest smaller (or same) value
+template <typename Key, typename Payload, typename Compare, typename Hash>
+const typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Index_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::Below(const Position_t &pos) const
+{
+    if (pos.offset > 0) {
+        return &m_chunks[pos.chunk][pos.offset - 1];
+    }
+    return (pos.chunk > 0) ? &m_chunks[pos.chunk - 1].back() : NULL;
+}
+
+//entry with the nearest bigger (or same) value
+template <typename Key, typename Payload, typename Compare, typename Hash>
+const typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Index_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::Above(const Position_t &pos) const
+{
+    if (pos.offset + 1 < m_chunks[pos.chunk].size()) {
+        return &m_chunks[pos.chunk][pos.offset + 1];
+    }
+    return (pos.chunk + 1 < m_chunks.size()) ? &m_chunks[pos.chunk + 1].front() : NULL;
+}
+
+//finding slot for entry and making room for it - full chunk is split in
+//halves; if memory runs out, index stays as it was
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Position_t BasicPriorityQueue<Key, Payload, Compare, Hash>::ReserveEntry(const Key &value, const Element_t *node)
+{
+    if (m_chunks.empty()) {
+        Chunk_t chunk;
+        chunk.reserve(INDEX_CHUNK_SIZE);
+        m_chunks.push_back(std::move(chunk));
+        Position_t pos = { 0, 0 };
+        return pos;
+    }
+
+    Position_t pos = SlotOf(value, node);
+    //entry bigger than all - it goes at the end of last chunk
+    if (pos.chunk == m_chunks.size()) {
+        pos.chunk--;
+        pos.offset = m_chunks[pos.chunk].size();
+    }
+
+    if (m_chunks[pos.chunk].size() == INDEX_CHUNK_SIZE) {
+        Chunk_t upper;
+        upper.reserve(INDEX_CHUNK_SIZE);
+        //moving chunks behind is the only O(n / INDEX_CHUNK_SIZE) step
+        m_chunks.insert(m_chunks.begin() + pos.chunk + 1, std::move(upper));
+
+        //chunks have reserved capacity, entries are only moved
+        Chunk_t &low = m_chunks[pos.chunk];
+        Chunk_t &high = m_chunks[pos.chunk + 1];
+        size_t half = INDEX_CHUNK_SIZE / 2;
+        high.insert(high.end(), std::make_move_iterator(low.begin() + half),
+                    std::make_move_iterator(low.end()));
+        low.erase(low.begin() + half, low.end());
+        if (pos.offset >= half) {
+            pos.chunk++;
+            pos.offset -= half;
+        }
+    }
+    return pos;
+}
+
+//placing entry to slot reserved by ReserveEntry
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::PlaceEntry(const Position_t &pos, Index_t &entry)
+{
+    Chunk_t &chunk = m_chunks[pos.chunk];
+    chunk.insert(chunk.begin() + pos.offset, std::move(entry));
+    m_length++;
+}
+
+//erasing entry from its chunk
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::EraseEntry(const Position_t &pos)
+{
+    Chunk_t &chunk = m_chunks[pos.chunk];
+    chunk.erase(chunk.begin() + pos.offset);
+    m_length--;
+    Rebalance(pos.chunk);
+}
+
+//merging small chunk with its neighbour or moving half of their entries to
+//it - both chunks have capacity INDEX_CHUNK_SIZE, so nothing is allocated
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::Rebalance(size_t chunk)
+{
+    if (m_chunks[chunk].size() >= INDEX_CHUNK_SIZE / 4) {
+        return;
+    }
+    //only chunk can be small, but not empty
+    if (m_chunks.size() == 1) {
+        if (m_chunks[0].empty()) {
+            m_chunks.clear();
+        }
+        return;
+    }
+
+    //pair of chunks - with next one, last chunk with previous one
+    size_t left = (chunk + 1 < m_chunks.size()) ? chunk : chunk - 1;
+    Chunk_t &low = m_chunks[left];
+    Chunk_t &high = m_chunks[left + 1];
+    if (low.size() + high.size() <= INDEX_CHUNK_SIZE) {
+        low.insert(low.end(), std::make_move_iterator(high.begin()), std::make_move_iterator(high.end()));
+        m_chunks.erase(m_chunks.begin() + left + 1);
+        return;
+    }
+
+    //both chunks will be at least half full
+    size_t half = (low.size() + high.size()) / 2;
+    if (low.size() < half) {
+        size_t moved = half - low.size();
+        low.insert(low.end(), std::make_move_iterator(high.begin()),
+                   std::make_move_iterator(high.begin() + moved));
+        high.erase(high.begin(), high.begin() + moved);
+    } else {
+        size_t moved = low.size() - half;
+        high.insert(high.begin(), std::make_move_iterator(low.end() - moved),
+                    std::make_move_iterator(low.end()));
+        low.erase(low.end() - moved, low.end());
+    }
+}
+
+//inserting more values at once - sorting them and merging with index; new
+//index is built aside and swapped in, so queue stays as it was on failure
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::InsertBatch(const std::vector<Key> &values)
+{
+    if (values.empty()) {
+        return;
+    }
+    std::vector<Index_t> batch;
+    batch.reserve(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        Index_t entry = { values[i], NULL };
+        batch.push_back(entry);
+    }
+
+    std::vector<Chunk_t> chunks;
+    //batch entries whose values were added to value index
+    std::vector<size_t> indexed;
+    size_t created = 0;
+    try {
+        //sorting values first, so nodes are created in the order of list
+        //(neighbours in list are mostly neighbours in pool block)
+        const BasicPriorityQueue<Key, Payload, Compare, Hash> *queue = this;
+        std::sort(batch.begin(), batch.end(),
+                  [queue](const Index_t &a, const Index_t &b) { return queue->m_compare(a.value, b.value); });
+
+        //creating nodes for new values
+        for (; created < batch.size(); created++) {
+            Element_t *node = AllocElement();
+            try {
+                Payload payload = Payload();
+                ConstructElement(node, batch[created].value, payload);
+            } catch (...) {
+                ReleaseElement(node);
+                throw;
+            }
+            batch[created].pElement = node;
+        }
+        //nodes from free list can have any address - ordering runs of same
+        //values by address
+        typename std::vector<Index_t>::iterator run = batch.begin();
+        while (run != batch.end()) {
+            typename std::vector<Index_t>::iterator last = run + 1;
+            while (last != batch.end() && Equal(last->value, run->value)) {
+                ++last;
+            }
+            std::sort(run, last, [](const Index_t &a, const Index_t &b) {
+                return std::less<const Element_t *>()(a.pElement, b.pElement);
+            });
+            run = last;
+        }
+
+        //value index gets only values which arent there yet
+        if (m_useValueIndex) {
+            indexed.reserve(batch.size());
+            for (size_t i = 0; i < batch.size(); i++) {
+                if (m_valueIndex.Add(batch[i].value, batch[i].pElement)) {
+                    indexed.push_back(i);
+                }
+            }
+        }
+
+        //merging with existing items (same value and address cant be there
+        //twice) into half full chunks
+        const size_t fill = INDEX_CHUNK_SIZE / 2;
+        chunks.reserve((m_length + batch.size()) / fill + 1);
+        typename std::vector<Index_t>::const_iterator next = batch.begin();
+        for (size_t c = 0; c < m_chunks.size(); c++) {
+            const Chunk_t &chunk = m_chunks[c];
+            for (size_t i = 0; i < chunk.size(); i++) {
+                while (next != batch.end() && EntryLess(*next, chunk[i].value, chunk[i].pElement)) {
+                    AppendEntry(chunks, *next++);
+                }
+                AppendEntry(chunks, chunk[i]);
+            }
+        }
+        while (next != batch.end()) {
+            AppendEntry(chunks, *next++);
+        }
+    } catch (...) {
+        for (size_t i = 0; i < indexed.size(); i++) {
+            m_valueIndex.Erase(batch[indexed[i]].value);
+        }
+        for (size_t i = 0; i < created; i++) {
+            FreeElement(batch[i].pElement);
+        }
+        throw;
+    }
+
+    //nothing below can fail - swapping index and linking all nodes in one pass
+    m_chunks.swap(chunks);
+    m_length += batch.size();
+    Element_t *pNext = NULL;
+    for (size_t c = 0; c < m_chunks.size(); c++) {
+        for (size_t i = 0; i < m_chunks[c].size(); i++) {
+            m_chunks[c][i].pElement->pNext = pNext;
+            pNext = m_chunks[c][i].pElement;
+        }
+    }
+    m_pHead = pNext;
+    CheckConsistency();
+}
+
+//appending entry to the last half full chunk of index which is being built
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::AppendEntry(std::vector<Chunk_t> &chunks, const Index_t &entry)
+{
+    if (chunks.empty() || chunks.back().size() == INDEX_CHUNK_SIZE / 2) {
+        Chunk_t chunk;
+        chunk.reserve(INDEX_CHUNK_SIZE);
+        chunks.push_back(std::move(chunk));
+    }
+    chunks.back().push_back(entry);
+}
+
+//setting value index for every run of same values
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::RebuildValueIndex()
+{
+    const Index_t *prev = NULL;
+    for (size_t c = 0; c < m_chunks.size(); c++) {
+        const Chunk_t &chunk = m_chunks[c];
+        for (size_t i = 0; i < chunk.size(); i++) {
+            if (prev == NULL || !Equal(prev->value, chunk[i].value)) {
+                m_valueIndex.Set(chunk[i].value, chunk[i].pElement);
+            }
+            prev = &chunk[i];
+        }
+    }
+}
+
+//taking node from free list, new block is carved when free list is empty
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Element_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::AllocElement()
+{
+    static_assert(alignof(Element_t) <= CACHE_LINE_SIZE,
+                  "bloky polozek jsou zarovnany jen na CACHE_LINE_SIZE");
+
+    if (m_pFreeList == NULL) {
+        //allocating block aligned to cache line
+        void *block = malloc(ELEMENTS_PER_BLOCK * sizeof(Element_t) + CACHE_LINE_SIZE - 1);
+        if (block == NULL) {
+            throw std::bad_alloc();
+        }
+        m_blocks.push_back(block);
+
+        size_t address = (size_t)block;
+        address = (address + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+        Element_t *elements = (Element_t *)address;
+
+        //linking nodes of block in memory order, so they are used one by one
+        for (size_t i = 0; i < ELEMENTS_PER_BLOCK - 1; i++) {
+            elements[i].pNext = &elements[i + 1];
+        }
+        elements[ELEMENTS_PER_BLOCK - 1].pNext = NULL;
+        m_pFreeList = elements;
+    }
+
+    Element_t *node = m_pFreeList;
+    m_pFreeList = node->pNext;
+    return node;
+}
+
+//removing item on position "pos" of index
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::RemoveAt(const Position_t &pos)
+{
+    Element_t *tmp = Entry(pos).pElement;
+    Unlink(pos);
+    EraseEntry(pos);
+    FreeElement(tmp);
+    CheckConsistency();
+}
+
+//removing "count" items from the end of index, rest of list stays linked
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::DropTop(size_t count)
+{
+    while (count > 0) {
+        Chunk_t &chunk = m_chunks.back();
+        size_t take = std::min(count, chunk.size());
+        for (size_t i = chunk.size(); i > chunk.size() - take; i--) {
+            const Index_t &entry = chunk[i - 1];
+            //items above were already dropped, so only item below can have the
+            //same value
+            if (m_useValueIndex) {
+                Position_t pos = { m_chunks.size() - 1, i - 1 };
+                const Index_t *below = Below(pos);
+                if (below == NULL || !Equal(below->value, entry.value)) {
+                    m_valueIndex.Erase(entry.value);
+                } else if (m_valueIndex.Find(entry.value) == entry.pElement) {
+                    m_valueIndex.Set(entry.value, below->pElement);
+                }
+            }
+            FreeElement(entry.pElement);
+        }
+        chunk.erase(chunk.end() - take, chunk.end());
+        m_length -= take;
+        count -= take;
+        if (chunk.empty()) {
+            m_chunks.pop_back();
+        }
+    }
+
+    if (m_chunks.empty()) {
+        m_pHead = NULL;
+    } else {
+        m_pHead = m_chunks.back().back().pElement;
+        Rebalance(m_chunks.size() - 1);
+    }
+    CheckConsistency();
+}
+
+//checking whole queue after change, only if PRIORITY_QUEUE_CHECK_CONSISTENCY
+//is defined (and NDEBUG isnt)
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::CheckConsistency() const
+{
+#ifdef PRIORITY_QUEUE_CHECK_CONSISTENCY
+    assert(IsConsistent());
+#endif
+}
+
+//unlinking item on position "pos" from list, entry in index is kept
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::Unlink(const Position_t &pos)
+{
+    Element_t *tmp = Entry(pos).pElement;
+    //value of node can be already changed (UpdatePriority), index has old one
+    const Key &value = Entry(pos).value;
+    const Index_t *above = Above(pos);
+    //removing first item
+    if (above == NULL) {
+        m_pHead = tmp->pNext;
+    //removing not first item
+    } else {
+        above->pElement->pNext = tmp->pNext;
+    }
+
+    //pointing value index to neighbour with the same value, if there is one
+    if (m_useValueIndex) {
+        const Index_t *below = Below(pos);
+        const Index_t *same = NULL;
+        if (below != NULL && Equal(below->value, value)) {
+            same = below;
+        } else if (above != NULL && Equal(above->value, value)) {
+            same = above;
+        }
+        if (same == NULL) {
+            m_valueIndex.Erase(value);
+        } else if (m_valueIndex.Find(value) == tmp) {
+            m_valueIndex.Set(value, same->pElement);
+        }
+    }
+}
+
+//linking item on position "pos" of index between its neighbours in list
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::Link(const Position_t &pos)
+{
+    Element_t *node = Entry(pos).pElement;
+    //node with the nearest smaller value is the next one in the list
+    const Index_t *below = Below(pos);
+    node->pNext = (below != NULL) ? below->pElement : NULL;
+    //node with the nearest bigger (or same) value points to the node
+    const Index_t *above = Above(pos);
+    if (above != NULL) {
+        above->pElement->pNext = node;
+    //there is no bigger value -> node is on first position
+    } else {
+        m_pHead = node;
+    }
+}
+
+//finding position of node in index - value and address identify it
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Position_t BasicPriorityQueue<Key, Payload, Compare, Hash>::PositionOf(Element_t *handle) const
+{
+    Position_t pos = SlotOf(handle->value, handle);
+    //handle isnt in the queue (it was already removed)
+    assert(pos.chunk < m_chunks.size() && Entry(pos).pElement == handle);
+    return pos;
+}
+
+//destroying value/payload and returning node to free list
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::FreeElement(Element_t *element)
+{
+    DestroyElement(element, ElementIsTriviallyDestructible());
+    ReleaseElement(element);
+}
+
+//returning node without value/payload to free list
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::ReleaseElement(Element_t *element)
+{
+    element->pNext = m_pFreeList;
+    m_pFreeList = element;
+}
+
+//constructing value and payload of node, value is destroyed if payload fails
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::ConstructElement(Element_t *node, const Key &value, Payload &payload)
+{
+    new (&node->value) Key(value);
+    try {
+        ConstructPayload(node, payload, PayloadIsTrivial());
+    } catch (...) {
+        node->value.~Key();
+        throw;
+    }
+}
+
+//ordering entries by value, entries with the same value by address of node
+template <typename Key, typename Payload, typename Compare, typename Hash>
+bool BasicPriorityQueue<Key, Payload, Compare, Hash>::EntryLess(const Index_t &entry, const Key &value, const Element_t *node) const
+{
+    if (m_compare(entry.value, value)) {
+        return true;
+    }
+    return !m_compare(value, entry.value) && std::less<const Element_t *>()(entry.pElement, node);
+}
+
+//values are equal if none of them is smaller
+template <typename Key, typename Payload, typename Compare, typename Hash>
+bool BasicPriorityQueue<Key, Payload, Compare, Hash>::Equal(const Key &a, const Key &b) const
+{
+    return !m_compare(a, b) && !m_compare(b, a);
+}
+
+//trivially copyable payload is copied byte by byte
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::ConstructPayload(Element_t *node, Payload &payload, std::true_type)
+{
+    memcpy((void *)&node->payload, (const void *)&payload, sizeof(Payload));
+}
+
+//other payloads are moved
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::ConstructPayload(Element_t *node, Payload &payload, std::false_type)
+{
+    new (&node->payload) Payload(std::move(payload));
+}
+
+//nothing to destroy
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::DestroyElement(Element_t *, std::true_type)
+{
+}
+
+//calling destructors of value and payload
+template <typename Key, typename Payload, typename Compare, typename Hash>
+void BasicPriorityQueue<Key, Payload, Compare, Hash>::DestroyElement(Element_t *node, std::false_type)
+{
+    node->value.~Key();
+    node->payload.~Payload();
+}
+
+//geting head of queue
+template <typename Key, typename Payload, typename Compare, typename Hash>
+typename BasicPriorityQueue<Key, Payload, Compare, Hash>::Element_t *BasicPriorityQueue<Key, Payload, Compare, Hash>::GetHead()
+{
+    return m_pHead;
+}
+
+#endif // TDD_CODE_IMPL_H_